@@ -0,0 +1,524 @@
+/*
+ * banc_essai.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Banc d'essai en ligne de commande (sans Qt ni caméra) : rejoue des images enregistrées
+ *  (TIFF : fake.tif, ou les t_obj.tif que Capture enregistre en DEBUG) et compare une
+ *  variante de la localisation avec la méthode de référence. Le nom "disque" à la place
+ *  d'un fichier est une image synthétique : un disque du diamètre de l'essai.
+ *
+ *    banc_essai <essai> [-d diametre] [-n images] [-t threads] image.tif...
+ *
+ *  Chaque image enregistrée donne une séquence de "images" images décalées d'un nombre
+ *  entier de pixels (dérive de l'ordre d'un pixel par image, comme pendant le suivi) :
+ *  le déplacement réel entre deux images est donc connu.
+ *
+ *  Le programme renvoie 1 si l'écart maximal dépasse la tolérance de l'essai (Essai::tolerance).
+ *
+ *  Essais :
+ *    fft       : espaces centrés de correlation_fft_centree et du Correlateur (FFT et directe)
+ *                contre correlation_rapide_centree, la fonction de référence
+ *    bande     : corrélation directe découpée en tuiles (Correlateur) contre l'ancienne boucle
+ *                de correlation_rapide_centree, sur une image de CAPTEUR_LIGNES x CAPTEUR_COLONNES
+ *    precision : corrélation directe en float (PRECISION_SIMPLE) contre double, sur
+ *                l'espace complet et sur la fenêtre de suivi
+ *    projections : suivi par Projections (estimation : position trouvée à l'image précédente)
+ *                contre la corrélation de la fenêtre de suivi et contre le décalage réel
+ *    limbe     : cercle ajusté sur le limbe, par moindres carrés et par RANSAC (centre converti
+ *                par Correlateur::centreVersPic) contre le pic de la corrélation complète
+ *    chamfer   : centre du cercle le plus proche des contours (Chamfer, converti de même)
+ *                contre le pic de la corrélation complète
+ *    elimination : maximum par élimination successive (Correlateur::chercherMaximum) contre
+ *                le maximum de la corrélation complète, et temps des deux
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+#include "image.h"
+#include "correlateur.h"
+#include "threads_calcul.h"
+#include "projections.h"
+#include "cercle.h"
+#include "chamfer.h"
+
+#define SEUIL_CORRELATION_ESSAI	0.90	// comme SEUIL_CORRELATION (capture.h)
+#define DEMI_FENETRE_ESSAI		20		// en px, comme le paramètre fenetre-suivi par défaut
+#define CAPTEUR_LIGNES			844		// Taille d'une image entière (essai "bande")
+#define CAPTEUR_COLONNES		1117
+#define DISQUE_LIGNES			440		// Taille de l'image synthétique "disque"
+#define DISQUE_COLONNES			600
+#define SEUIL_LIMBE_ESSAI		0.3		// comme SEUIL_LIMBE (capture.h)
+#define PAS_LIMBE_ESSAI			2		// comme PAS_LIMBE (capture.h)
+#define TOLERANCE_RANSAC_ESSAI	1.5		// comme TOLERANCE_RANSAC (capture.h)
+#define DUREE_RANSAC_ESSAI		0.005	// comme DUREE_RANSAC (capture.h)
+#define RATIO_INLIERS_MIN_ESSAI	0.5		// comme RATIO_INLIERS_MIN (capture.h)
+#define CONTRASTE_PROJECTIONS_ESSAI	1.05	// comme CONTRASTE_PROJECTIONS_MIN (capture.h)
+
+static int diametre_essai = 275;		// en px, paramètre -d
+
+/**
+ * Copie de l'image décalée de (dl, dc) pixels ; les pixels qui entrent par le bord
+ * prennent la valeur du bord le plus proche
+ */
+static Image* decaler(Image& img, int dl, int dc) {
+	int lignes = img.getLignes(), colonnes = img.getColonnes();
+	Image* dst = new Image(lignes, colonnes);
+	for (int l=0; l < lignes; l++) {
+		int l_src = max(0, min(lignes-1, l - dl));
+		for (int c=0; c < colonnes; c++) {
+			dst->setPix(l, c, img.getPix(l_src, max(0, min(colonnes-1, c - dc))));
+		}
+	}
+	return dst;
+}
+
+/**
+ * Image synthétique "disque" : disque du diamètre donné, tracé comme la forme de la
+ * référence (Image::tracerFormeSoleil), au centre d'une image de DISQUE_LIGNES x DISQUE_COLONNES
+ */
+static Image* tracerDisque(int diametre) {
+	const double marge = 2.5;
+	Image* img = new Image(DISQUE_LIGNES, DISQUE_COLONNES);
+	img->tracerDonut(DISQUE_LIGNES/2, DISQUE_COLONNES/2, 0, 0, diametre/2 - marge/2, marge);
+	img->normaliser();
+	return img;
+}
+
+/**
+ * Décalage de l'image k de la séquence (dérive lente en diagonale, avec des allers-retours)
+ */
+static void decalageSequence(int k, int *dl, int *dc) {
+	*dl = k/2 - ((k/8) % 2) * (k % 8);
+	*dc = k - ((k/6) % 2) * (k % 6);
+}
+
+/**
+ * Temps écoulé (horloge murale) en s depuis "debut"
+ */
+static double secondesDepuis(const timespec& debut) {
+	timespec fin;
+	clock_gettime(CLOCK_MONOTONIC, &fin);
+	return (fin.tv_sec - debut.tv_sec) + 1e-9*(fin.tv_nsec - debut.tv_nsec);
+}
+
+/**
+ * Écart maximal entre deux espaces de même taille, relatif au maximum du second
+ */
+static double ecartRelatif(Image& a, Image& b) {
+	double ecart = 0;
+	for (int l=0; l < a.getLignes(); l++) {
+		for (int c=0; c < a.getColonnes(); c++) {
+			ecart = max(ecart, fabs(a.getPix(l,c) - b.getPix(l,c)));
+		}
+	}
+	b.reinitialiserMinMax();
+	return ecart / b.valeurMax();
+}
+
+/**
+ * Écart absolu maximal entre deux espaces de même taille
+ */
+static double ecartAbsolu(Image& a, Image& b) {
+	double ecart = 0;
+	for (int l=0; l < a.getLignes(); l++) {
+		for (int c=0; c < a.getColonnes(); c++) {
+			ecart = max(ecart, fabs(a.getPix(l,c) - b.getPix(l,c)));
+		}
+	}
+	return ecart;
+}
+
+/**
+ * Essai "fft" : correlation_rapide_centree, correlation_fft_centree et le Correlateur (FFT et
+ * directe en double) normalisent tous l'espace par son maximum sur [0, INTENSITE_MAX] : leurs
+ * espaces centrés doivent être les mêmes à l'arrondi près
+ * @return Le plus grand écart absolu avec correlation_rapide_centree
+ */
+static double essaiFFT(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int /* dl */, int /* dc */) {
+	static Correlateur *fft = NULL, *directe = NULL;
+	if(fft == NULL) {
+		fft = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_FFT, threads);
+		directe = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_DIRECTE, threads);
+	}
+	Image* rapide = obj.correlation_rapide_centree(ref_lapl, SEUIL_CORRELATION_ESSAI);
+	Image* fft_centree = obj.correlation_fft_centree(ref_lapl, SEUIL_CORRELATION_ESSAI);
+	double ecart_fft_centree = ecartAbsolu(*fft_centree, *rapide);
+	double ecart_fft = ecartAbsolu(*fft->correler(obj), *rapide);
+	double ecart_directe = ecartAbsolu(*directe->correler(obj), *rapide);
+	printf("%4d  pic (%4d, %4d)  ecart absolu a correlation_rapide_centree (sur %d) : correlation_fft_centree %.1e,"
+			" Correlateur FFT %.1e, Correlateur directe %.1e\n", num_image, rapide->posMaxLigne(), rapide->posMaxColonne(),
+			INTENSITE_MAX, ecart_fft_centree, ecart_fft, ecart_directe);
+	delete rapide;
+	delete fft_centree;
+	return max(ecart_fft_centree, max(ecart_fft, ecart_directe));
+}
+
+/**
+ * Essai "bande" : l'image est placée au centre d'une image de CAPTEUR_LIGNES x CAPTEUR_COLONNES.
+ * correlation_rapide_centree parcourt tout l'espace complet pour chaque point de la référence
+ * (lu et réécrit : points x espace x 3 MonDouble), le Correlateur accumule tous les points tuile
+ * par tuile (espace écrit une fois, plus l'objet sous chaque tuile agrandie de la référence).
+ * Le trafic mémoire est estimé à partir de ces tailles, sans tenir compte du cache (majorant).
+ * @return L'écart entre les positions des deux maximums, en px
+ */
+static double essaiBande(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int /* dl */, int /* dc */) {
+	static Correlateur *tuiles = NULL;
+	if(tuiles == NULL) {
+		tuiles = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_DIRECTE, threads);
+	}
+	Image capteur(CAPTEUR_LIGNES, CAPTEUR_COLONNES);
+	capteur.init(0);
+	int l_0 = max(0, (CAPTEUR_LIGNES - obj.getLignes())/2), c_0 = max(0, (CAPTEUR_COLONNES - obj.getColonnes())/2);
+	for (int l=0; l < min(obj.getLignes(), CAPTEUR_LIGNES); l++) {
+		for (int c=0; c < min(obj.getColonnes(), CAPTEUR_COLONNES); c++) {
+			capteur.setPix(l_0 + l, c_0 + c, obj.getPix(l, c));
+		}
+	}
+	timespec debut;
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	Image* ancienne = capteur.correlation_rapide_centree(ref_lapl, SEUIL_CORRELATION_ESSAI);
+	double duree_ancienne = secondesDepuis(debut);
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	Image* espace = tuiles->correler(capteur);
+	double duree_tuiles = secondesDepuis(debut);
+
+	int ref_lignes = ref_lapl.getLignes(), ref_colonnes = ref_lapl.getColonnes();
+	double points = tuiles->getNombrePoints();
+	double complet = (double)(CAPTEUR_LIGNES + ref_lignes-1) * (CAPTEUR_COLONNES + ref_colonnes-1);
+	double octets_ancienne = points * complet * 3 * sizeof(MonDouble);
+	double nb_tuiles = (double)((CAPTEUR_LIGNES + TUILE_LIGNES-1)/TUILE_LIGNES) * ((CAPTEUR_COLONNES + TUILE_COLONNES-1)/TUILE_COLONNES);
+	double octets_tuiles = (double)CAPTEUR_LIGNES * CAPTEUR_COLONNES * sizeof(MonDouble)
+			+ nb_tuiles * (TUILE_LIGNES + ref_lignes) * (TUILE_COLONNES + ref_colonnes) * sizeof(MonDouble);
+	double ecart = max(abs(ancienne->posMaxLigne() - espace->posMaxLigne()), abs(ancienne->posMaxColonne() - espace->posMaxColonne()));
+	printf("%4d  %d x %d, %.0f points  |  correlation_rapide_centree %.3f s, trafic au plus %.0f Mo (%.1f Go/s)"
+			"  |  tuiles %.3f s, trafic au plus %.0f Mo (%.1f Go/s)  |  ecart des maximums %.0f px\n",
+			num_image, CAPTEUR_LIGNES, CAPTEUR_COLONNES, points, duree_ancienne, octets_ancienne/1e6,
+			octets_ancienne/1e9/duree_ancienne, duree_tuiles, octets_tuiles/1e6, octets_tuiles/1e9/duree_tuiles, ecart);
+	delete ancienne;
+	return ecart;
+}
+
+/**
+ * Essai "precision" : la même image corrélée en double et en float, sur l'espace complet
+ * puis sur la fenêtre de suivi (avec sa marge) autour du pic
+ * @return L'écart de position maximal, en px
+ */
+static double essaiPrecision(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int /* dl */, int /* dc */) {
+	static Correlateur *en_double = NULL, *en_float = NULL;
+	if(en_double == NULL) {
+		en_double = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_DIRECTE, threads, PRECISION_DOUBLE);
+		en_float = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_DIRECTE, threads, PRECISION_SIMPLE);
+	}
+	timespec debut;
+	double l_double, c_double, l_float, c_float;
+	Image espace_double(obj.getLignes(), obj.getColonnes());
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	espace_double.copier(*en_double->correler(obj));
+	double duree_double = secondesDepuis(debut);
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	Image* espace_float = en_float->correler(obj);
+	double duree_float = secondesDepuis(debut);
+	espace_double.maxParInterpolation(&l_double, &c_double);
+	espace_float->maxParInterpolation(&l_float, &c_float);
+	double ecart_complet = max(fabs(l_float - l_double), fabs(c_float - c_double));
+	double ecart_valeurs = ecartRelatif(*espace_float, espace_double);
+
+	int l_pic = espace_double.posMaxLigne(), c_pic = espace_double.posMaxColonne();
+	int demi_taille = DEMI_FENETRE_ESSAI + en_double->getDemiLobes();
+	Image* fenetre = en_double->correlerFenetre(obj, l_pic, c_pic, demi_taille);
+	Image fenetre_double(fenetre->getLignes(), fenetre->getColonnes());
+	fenetre_double.copier(*fenetre);
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	Image* fenetre_float = en_float->correlerFenetre(obj, l_pic, c_pic, demi_taille);
+	double duree_fenetre = secondesDepuis(debut);
+	fenetre_double.maxParInterpolation(&l_double, &c_double);
+	fenetre_float->maxParInterpolation(&l_float, &c_float);
+	double ecart_fenetre = max(fabs(l_float - l_double), fabs(c_float - c_double));
+
+	printf("%4d  pic (%4d, %4d)  complet : ecart %.4f px, %.1e du max, %.3f s en double, %.3f s en float"
+			"  |  fenetre : ecart %.4f px, %.4f s en float\n", num_image, l_pic, c_pic,
+			ecart_complet, ecart_valeurs, duree_double, duree_float, ecart_fenetre, duree_fenetre);
+	return max(ecart_complet, ecart_fenetre);
+}
+
+/**
+ * Essai "projections" : comme pendant le suivi, Projections cherche autour de la position
+ * trouvée à l'image précédente, et la corrélation de la fenêtre de suivi autour de la même
+ * estimation sert de comparaison. La première image d'un fichier (décalage nul) est localisée
+ * par la corrélation complète, qui donne aussi le biais des projections (retranché ensuite,
+ * comme Capture le fait à chaque localisation complète) ; pour chaque méthode, l'erreur de
+ * suivi est l'écart entre le déplacement mesuré depuis la première image et le décalage réel.
+ * Comme dans Capture, une image sans pic ou de contraste inférieur à CONTRASTE_PROJECTIONS_ESSAI
+ * n'est pas localisée par les projections (pas d'écart).
+ * @param dl Décalage réel de l'image par rapport à la première
+ * @param dc
+ * @return Le plus grand écart de position des projections (à la corrélation, ou erreur de suivi), en px
+ */
+static double essaiProjections(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int dl, int dc) {
+	static Correlateur *correlateur = NULL;
+	static Projections *projections = NULL;
+	static double origine_l, origine_c, estime_l, estime_c, origine_proj_l, origine_proj_c, biais_l, biais_c;
+	if(correlateur == NULL) {
+		correlateur = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_FFT, threads);
+		projections = new Projections(ref_lapl, SEUIL_CORRELATION_ESSAI);
+	}
+	if(dl == 0 && dc == 0) {
+		correlateur->correler(obj)->maxParInterpolation(&origine_l, &origine_c);
+		estime_l = origine_l;
+		estime_c = origine_c;
+		biais_l = biais_c = 0;
+	}
+	timespec debut;
+	double l_proj, c_proj, contraste, l_correl, c_correl;
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	bool trouvee = projections->trouverPosition(obj, estime_l + biais_l, estime_c + biais_c, DEMI_FENETRE_ESSAI,
+			&l_proj, &c_proj, &contraste);
+	double duree_proj = secondesDepuis(debut);
+	if(trouvee && dl == 0 && dc == 0) {
+		biais_l = l_proj - origine_l;
+		biais_c = c_proj - origine_c;
+	}
+	l_proj -= biais_l;
+	c_proj -= biais_c;
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	// Même fenêtre que Capture::trouverPositionDansFenetre (maxParInterpolation lit 10 px autour du pic)
+	Image* fenetre = correlateur->correlerFenetre(obj, (int)(estime_l + 0.5), (int)(estime_c + 0.5),
+			DEMI_FENETRE_ESSAI + correlateur->getDemiLobes());
+	fenetre->maxParInterpolation(&l_correl, &c_correl);
+	l_correl += correlateur->getFenetreLigne();
+	c_correl += correlateur->getFenetreColonne();
+	double duree_fenetre = secondesDepuis(debut);
+	if(dl == 0 && dc == 0) {
+		origine_proj_l = l_proj;
+		origine_proj_c = c_proj;
+	}
+	if(!trouvee || contraste < CONTRASTE_PROJECTIONS_ESSAI) {
+		printf("%4d  decalage (%d, %d) : projections sans pic dans la fenetre ou contraste %.3f insuffisant\n",
+				num_image, dl, dc, trouvee ? contraste : 0);
+		estime_l = l_correl;
+		estime_c = c_correl;
+		return 0;
+	}
+	double ecart_correl = max(fabs(l_proj - l_correl), fabs(c_proj - c_correl));
+	double suivi_proj = max(fabs(l_proj - origine_proj_l - dl), fabs(c_proj - origine_proj_c - dc));
+	double suivi_correl = max(fabs(l_correl - origine_l - dl), fabs(c_correl - origine_c - dc));
+	printf("%4d  decalage (%d, %d)  projections (%.3f, %.3f), biais (%.3f, %.3f), contraste %.3f en %.4f s"
+			"  |  fenetre (%.3f, %.3f) en %.4f s  |  ecart %.3f px a la fenetre, erreur de suivi %.3f px (fenetre : %.3f px)\n", num_image, dl, dc,
+			l_proj, c_proj, biais_l, biais_c, contraste, duree_proj, l_correl, c_correl, duree_fenetre, ecart_correl,
+			suivi_proj, suivi_correl);
+	estime_l = l_proj;
+	estime_c = c_proj;
+	return max(ecart_correl, suivi_proj);
+}
+
+/**
+ * Cercle du limbe comme Capture::trouverPositionParLimbe : points du limbe puis ajustement
+ * par moindres carrés ou, si ransac, par cercle_ransac (même tirage que Capture)
+ * @param ratio Proportion des points cohérents avec le cercle (RANSAC seulement)
+ * @return false si l'ajustement est impossible ou, en RANSAC, si trop peu de points sont cohérents
+ */
+static bool ajusterLimbe(Image& obj, bool ransac, Cercle* cercle, double* ratio) {
+	int taille = 2*(obj.getLignes() + obj.getColonnes());
+	double *limbe_l = new double[taille], *limbe_c = new double[taille];
+	int n = obj.extrairePointsLimbe(SEUIL_LIMBE_ESSAI, PAS_LIMBE_ESSAI, limbe_l, limbe_c, taille);
+	unsigned int graine = 1;
+	*ratio = 0;
+	bool ajuste = ransac
+			? cercle_ransac(limbe_l, limbe_c, n, TOLERANCE_RANSAC_ESSAI, 0.45*diametre_essai, 0.55*diametre_essai,
+					DUREE_RANSAC_ESSAI, &graine, cercle, ratio) && *ratio >= RATIO_INLIERS_MIN_ESSAI
+			: cercle_ajuster(limbe_l, limbe_c, n, cercle);
+	delete [] limbe_l;
+	delete [] limbe_c;
+	return ajuste;
+}
+
+/**
+ * Essai "limbe" : les cercles ajustés sur les points du limbe par moindres carrés et par RANSAC
+ * (Capture en LOCALISATION_LIMBE et LOCALISATION_LIMBE_RANSAC), centres convertis dans la
+ * convention de la corrélation, doivent tomber sur le pic de la corrélation complète : la
+ * position ne saute pas quand Capture passe d'une méthode à l'autre. Le diamètre (-d) doit
+ * être celui du soleil de l'image : avec une référence trop petite ou trop grande, c'est le
+ * pic de corrélation qui s'écarte du centre.
+ * @return L'écart de position maximal, en px
+ */
+static double essaiLimbe(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int /* dl */, int /* dc */) {
+	static Correlateur *correlateur = NULL;
+	if(correlateur == NULL) {
+		correlateur = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_FFT, threads);
+	}
+	double l_correl, c_correl;
+	correlateur->correler(obj)->maxParInterpolation(&l_correl, &c_correl);
+	printf("%4d  correlation (%.3f, %.3f)", num_image, l_correl, c_correl);
+	double pire = 0;
+	for (int ransac=0; ransac < 2; ransac++) {
+		Cercle cercle;
+		double ratio;
+		if(!ajusterLimbe(obj, ransac, &cercle, &ratio)) {
+			printf("  |  %s : pas de cercle (%.0f%% de points coherents)", ransac ? "RANSAC" : "limbe", 100*ratio);
+			pire = HUGE_VAL;
+			continue;
+		}
+		double l_centre = cercle.l, c_centre = cercle.c;
+		correlateur->centreVersPic(&cercle.l, &cercle.c);
+		double ecart = max(fabs(cercle.l - l_correl), fabs(cercle.c - c_correl));
+		printf("  |  %s : centre (%.3f, %.3f), converti (%.3f, %.3f), diametre %.2f px, ", ransac ? "RANSAC" : "limbe",
+				l_centre, c_centre, cercle.l, cercle.c, 2*cercle.rayon);
+		if(ransac) {
+			printf("%.0f%% de points coherents", 100*ratio);
+		} else {
+			printf("residu %.3f px sur %d points", cercle.residu, cercle.nb_points);
+		}
+		printf(", ecart %.3f px", ecart);
+		pire = max(pire, ecart);
+	}
+	printf("\n");
+	return pire;
+}
+
+/**
+ * Essai "chamfer" : comme l'essai "limbe", pour le centre trouvé par Chamfer (Capture en
+ * LOCALISATION_CHAMFER), converti dans la convention de la corrélation
+ * @return L'écart de position maximal, en px
+ */
+static double essaiChamfer(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int /* dl */, int /* dc */) {
+	static Correlateur *correlateur = NULL;
+	static Chamfer chamfer;
+	if(correlateur == NULL) {
+		correlateur = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_FFT, threads);
+	}
+	double l_correl, c_correl;
+	correlateur->correler(obj)->maxParInterpolation(&l_correl, &c_correl);
+	double l, c, ratio;
+	timespec debut;
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	bool trouvee = chamfer.trouverPosition(obj, diametre_essai, &l, &c, &ratio) && ratio >= RATIO_INLIERS_MIN_ESSAI;
+	double duree = secondesDepuis(debut);
+	if(!trouvee) {
+		printf("%4d  correlation (%.3f, %.3f)  |  chamfer : pas de cercle (%.0f%% du cercle sur le limbe)\n",
+				num_image, l_correl, c_correl, 100*ratio);
+		return HUGE_VAL;
+	}
+	double l_centre = l, c_centre = c;
+	correlateur->centreVersPic(&l, &c);
+	double ecart = max(fabs(l - l_correl), fabs(c - c_correl));
+	printf("%4d  correlation (%.3f, %.3f)  |  chamfer : centre (%.3f, %.3f), converti (%.3f, %.3f), %.0f%% du cercle"
+			" sur le limbe, en %.4f s  |  ecart %.3f px\n", num_image, l_correl, c_correl, l_centre, c_centre, l, c,
+			100*ratio, duree, ecart);
+	return ecart;
+}
+
+/**
+ * Essai "elimination" : le maximum exact par élimination successive doit être exactement
+ * celui de la corrélation complète (méthode directe) ; une recherche abandonnée
+ * (TRAVAIL_MAX_ELIMINATION) compte comme un échec
+ * @return L'écart entre les positions des deux maximums, en px
+ */
+static double essaiElimination(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int /* dl */, int /* dc */) {
+	static Correlateur *correlateur = NULL;
+	if(correlateur == NULL) {
+		correlateur = new Correlateur(ref_lapl, SEUIL_CORRELATION_ESSAI, CORRELATION_DIRECTE, threads);
+	}
+	timespec debut;
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	Image* espace = correlateur->correler(obj);
+	double duree_correl = secondesDepuis(debut);
+	int l_correl = espace->posMaxLigne(), c_correl = espace->posMaxColonne();
+	int l, c;
+	clock_gettime(CLOCK_MONOTONIC, &debut);
+	bool trouve = correlateur->chercherMaximum(obj, &l, &c);
+	double duree = secondesDepuis(debut);
+	if(!trouve) {
+		printf("%4d  correlation (%d, %d) en %.4f s  |  elimination : abandon en %.4f s\n",
+				num_image, l_correl, c_correl, duree_correl, duree);
+		return HUGE_VAL;
+	}
+	double ecart = max(abs(l - l_correl), abs(c - c_correl));
+	printf("%4d  correlation (%d, %d) en %.4f s  |  elimination (%d, %d) en %.4f s  |  ecart %.0f px\n",
+			num_image, l_correl, c_correl, duree_correl, l, c, duree, ecart);
+	return ecart;
+}
+
+/**
+ * Un essai : la fonction appelée pour chaque image de la séquence renvoie un écart (en px
+ * ou en valeur), dont le maximum sur toutes les images est comparé à la tolérance
+ */
+typedef struct {
+	const char* nom;
+	double (*faire)(Image& obj, Image& ref_lapl, ThreadsCalcul* threads, int num_image, int dl, int dc);
+	const char* compare;	// Ce qui est comparé, pour le résumé
+	double tolerance;
+} Essai;
+
+static const Essai essais[] = {
+	{"fft", essaiFFT, "FFT, directe / correlation_rapide_centree (valeurs)", 1e-6},
+	{"bande", essaiBande, "tuiles / correlation_rapide_centree (maximum)", 0},
+	{"precision", essaiPrecision, "float / double", 0.01},
+	{"projections", essaiProjections, "projections / (fenetre, decalage reel)", 0.25},
+	{"limbe", essaiLimbe, "limbe, RANSAC / correlation", 0.5},
+	{"chamfer", essaiChamfer, "chamfer / correlation", 0.5},
+	{"elimination", essaiElimination, "elimination / correlation (maximum)", 0}
+};
+static const int nb_essais = sizeof(essais)/sizeof(essais[0]);
+
+static void usage() {
+	fprintf(stderr, "usage : banc_essai <essai> [-d diametre] [-n images] [-t threads] image.tif...\nessais :");
+	for (int k=0; k < nb_essais; k++) {
+		fprintf(stderr, " %s", essais[k].nom);
+	}
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+int main(int argc, char **argv) {
+	if(argc < 3) {
+		usage();
+	}
+	const char* essai = argv[1];
+	int images_par_fichier = 8, nb_threads = 1;
+	int i = 2;
+	for (; i < argc && argv[i][0] == '-'; i += 2) {
+		if(i+1 >= argc) usage();
+		if(strcmp(argv[i], "-d") == 0) diametre_essai = atoi(argv[i+1]);
+		else if(strcmp(argv[i], "-n") == 0) images_par_fichier = max(1, atoi(argv[i+1]));
+		else if(strcmp(argv[i], "-t") == 0) nb_threads = max(1, atoi(argv[i+1]));
+		else usage();
+	}
+	const Essai* choisi = NULL;
+	for (int k=0; k < nb_essais; k++) {
+		if(strcmp(essai, essais[k].nom) == 0) choisi = &essais[k];
+	}
+	if(i >= argc || choisi == NULL) {
+		usage();
+	}
+	Image* ref = Image::tracerFormeSoleil(diametre_essai);
+	Image* ref_lapl = ref->convoluerParDerivee();
+	ThreadsCalcul* threads = (nb_threads > 1) ? new ThreadsCalcul(nb_threads) : NULL;
+
+	double pire = 0;
+	int num_image = 0;
+	for (; i < argc; i++) {
+		Image* enregistree = (strcmp(argv[i], "disque") == 0) ? tracerDisque(diametre_essai) : Image::depuisTiff(argv[i]);
+		printf("%s : %d x %d, diametre %d px\n", argv[i], enregistree->getLignes(), enregistree->getColonnes(), diametre_essai);
+		for (int k=0; k < images_par_fichier; k++, num_image++) {
+			int dl, dc;
+			decalageSequence(k, &dl, &dc);
+			Image* img = decaler(*enregistree, dl, dc);
+			Image* obj = img->convoluerParDerivee();
+			pire = max(pire, choisi->faire(*obj, *ref_lapl, threads, num_image, dl, dc));
+			delete obj;
+			delete img;
+		}
+		delete enregistree;
+	}
+	bool reussi = pire <= choisi->tolerance;
+	printf("Ecart maximal %s : %.4g sur %d images, tolerance %g : %s\n", choisi->compare, pire, num_image,
+			choisi->tolerance, reussi ? "OK" : "ECHEC");
+	delete ref;
+	delete ref_lapl;
+	if(threads) delete threads;
+	return reussi ? 0 : 1;
+}
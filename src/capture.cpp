@@ -23,6 +23,7 @@
  */
 
 #include "capture.h"
+#include <cmath>
 
 /**
  * Paramètres chargés pour la capture (fichier ~/.config/irap/climso-auto.conf sous linux)
@@ -34,6 +35,53 @@ void Capture::chargerParametres() {
 	QSettings parametres("irap", "climso-auto");
 	diametre = parametres.value("diametre-soleil-en-pixel", 275).toInt(); // diamètre du soleil en pixels
 	normaliserImageAffichee = parametres.value("normaliser-image-affichee", true).toBool();
+	// "fft" (par défaut), "directe" (correlation_rapide_centree, plus lente, sert de référence)
+	// ou "segments" (méthode directe avec un anneau de poids constant, par sommes cumulées)
+	QString methode = parametres.value("methode-correlation", "fft").toString();
+	methodeCorrelation = CORRELATION_FFT;
+	if(methode == "directe") methodeCorrelation = CORRELATION_DIRECTE;
+	if(methode == "segments") methodeCorrelation = CORRELATION_SEGMENTS;
+	// "double" (par défaut) ou "simple" : méthode directe et suivi calculés en float
+	QString precision = parametres.value("precision-correlation", "double").toString();
+	precisionCorrelation = (precision == "simple") ? PRECISION_SIMPLE : PRECISION_DOUBLE;
+	// "max" (par défaut, qualité = rapport pic/lobes) ou "zncc" (corrélation normalisée centrée,
+	// qualité = 100 x score du pic, qui ne dépend pas de la luminosité de l'image)
+	normalisationCorrelation = (parametres.value("normalisation-correlation", "max").toString() == "zncc") ?
+			NORMALISATION_ZNCC : NORMALISATION_MAX;
+	// "hough" (par défaut) ou "correlation" (une corrélation par diamètre) pour chercherDiametreProche()
+	rechercheDiametre = (parametres.value("recherche-diametre", "hough").toString() == "correlation") ?
+			DIAMETRE_CORRELATION : DIAMETRE_HOUGH;
+	// "correlation" (par défaut), "phase" (corrélation de phase avec l'image prise au reset de la consigne)
+	// "limbe" (cercle ajusté sur les points du limbe), "limbe-ransac" (idem, robuste aux nuages)
+	// ou "chamfer" (cercle le plus proche des contours, robuste aux nuages)
+	QString localisation = parametres.value("localisation", "correlation").toString();
+	methodeLocalisation = LOCALISATION_CORRELATION;
+	if(localisation == "phase") methodeLocalisation = LOCALISATION_PHASE;
+	if(localisation == "limbe") methodeLocalisation = LOCALISATION_LIMBE;
+	if(localisation == "limbe-ransac") methodeLocalisation = LOCALISATION_LIMBE_RANSAC;
+	if(localisation == "chamfer") methodeLocalisation = LOCALISATION_CHAMFER;
+	demiFenetreSuivi = parametres.value("fenetre-suivi", 20).toInt(); // en px autour de la dernière position
+	// Recherche "grossière puis fine" quand il n'y a pas de position pour le suivi (entre 1 et NIVEAUX_PYRAMIDE_MAX)
+	niveauxPyramide = parametres.value("niveaux-pyramide", 3).toInt();
+	niveauxPyramide = max(1, min(niveauxPyramide, NIVEAUX_PYRAMIDE_MAX));
+	// Recherche grossière sur les contours binaires (CorrelateurBinaire) puis affinage, avant la pyramide
+	rechercheBinaire = parametres.value("recherche-binaire", false).toBool();
+	// Maximum exact de la corrélation par élimination successive (Correlateur::chercherMaximum), avant la pyramide
+	rechercheExacte = parametres.value("recherche-exacte", false).toBool();
+	// Entre deux localisations complètes, N-1 images localisées par projections (0 : jamais)
+	intervalleProjections = max(0, parametres.value("intervalle-projections", 0).toInt());
+	// En ms après la lecture de l'image : on rend la meilleure estimation obtenue avant ce délai (0 : pas de délai)
+	delaiLocalisation = max(0, parametres.value("delai-localisation", 0).toInt());
+	// Threads de corrélation ; par défaut on laisse un coeur pour l'interface et la caméra
+	int nombreThreads = max(1, parametres.value("nombre-threads-correlation", QThread::idealThreadCount()-1).toInt());
+	if(threadsCorrelation == NULL || threadsCorrelation->getNombreThreads() != nombreThreads) {
+		// Les anciens correlateurs (qui utilisent ces threads) sont reconstruits par modifierDiametre()
+		if(threadsCorrelation) delete threadsCorrelation;
+		threadsCorrelation = new ThreadsCalcul(nombreThreads);
+		if(hough) delete hough; // reconstruit par chercherDiametreProche()
+		hough = NULL;
+	}
+	seuilSignalBruit = parametres.value("seuil-signal-bruit",10).toDouble(); // modifié depuis menu > paramètres
 	modifierDiametre(diametre);
 	emit diametreSoleil(diametre);
 }
@@ -42,17 +90,72 @@ void Capture::enregistrerParametres() {
 	QSettings parametres("irap", "climso-auto");
 	parametres.setValue("diametre-soleil-en-pixel", diametre);
 	parametres.setValue("normaliser-image-affichee",normaliserImageAffichee);
+	switch(methodeCorrelation) {
+	case CORRELATION_DIRECTE: parametres.setValue("methode-correlation", "directe"); break;
+	case CORRELATION_SEGMENTS: parametres.setValue("methode-correlation", "segments"); break;
+	default: parametres.setValue("methode-correlation", "fft"); break;
+	}
+	parametres.setValue("precision-correlation", (precisionCorrelation == PRECISION_SIMPLE) ? "simple" : "double");
+	parametres.setValue("normalisation-correlation", (normalisationCorrelation == NORMALISATION_ZNCC) ? "zncc" : "max");
+	parametres.setValue("recherche-diametre", (rechercheDiametre == DIAMETRE_CORRELATION) ? "correlation" : "hough");
+	switch(methodeLocalisation) {
+	case LOCALISATION_PHASE: parametres.setValue("localisation", "phase"); break;
+	case LOCALISATION_LIMBE: parametres.setValue("localisation", "limbe"); break;
+	case LOCALISATION_LIMBE_RANSAC: parametres.setValue("localisation", "limbe-ransac"); break;
+	case LOCALISATION_CHAMFER: parametres.setValue("localisation", "chamfer"); break;
+	default: parametres.setValue("localisation", "correlation"); break;
+	}
+	parametres.setValue("fenetre-suivi", demiFenetreSuivi);
+	parametres.setValue("niveaux-pyramide", niveauxPyramide);
+	parametres.setValue("recherche-binaire", rechercheBinaire);
+	parametres.setValue("recherche-exacte", rechercheExacte);
+	parametres.setValue("intervalle-projections", intervalleProjections);
+	parametres.setValue("delai-localisation", delaiLocalisation);
+	if(threadsCorrelation) parametres.setValue("nombre-threads-correlation", threadsCorrelation->getNombreThreads());
 }
 
 Capture::Capture() {
 	img = NULL;
 	ref_lapl = NULL;
+	obj_lapl = NULL;
+	correlateur = NULL;
+	for(int k=0; k < NIVEAUX_PYRAMIDE_MAX; k++) {
+		correlateursPyramide[k] = NULL;
+		pyramide[k] = NULL;
+	}
+	niveauxPyramide = 3;
+	threadsCorrelation = NULL;
+	correlateurBinaire = NULL;
+	rechercheBinaire = false;
+	rechercheExacte = false;
+	projections = NULL;
+	intervalleProjections = imagesParProjections = 0;
+	contrasteProjections = signalbruitProjections = 0;
+	biaisProjections_l = biaisProjections_c = 0;
+	delaiLocalisation = dureeCorrelationComplete = 0;
+	niveauLocalisation = NIVEAU_AUCUN;
+	grossier_l = grossier_c = grossier_signalbruit = 0;
+	grossierValide = false;
+	methodeCorrelation = CORRELATION_FFT;
+	precisionCorrelation = PRECISION_DOUBLE;
+	normalisationCorrelation = NORMALISATION_MAX;
+	rechercheDiametre = DIAMETRE_HOUGH;
+	hough = NULL;
+	methodeLocalisation = LOCALISATION_CORRELATION;
+	limbe_l = limbe_c = NULL;
+	limbe_taille = 0;
 	position_c = position_l = 0;
+	positionValide = false;
+	centroide_l = centroide_c = 0;
+	centroideValide = centroideIncoherent = false;
+	demiFenetreSuivi = 20;
+	seuilSignalBruit = 10;
 	diametre = 0;
 	QObject::connect(&timerProchaineCapture,SIGNAL(timeout()),this,SLOT(captureEtPosition()), Qt::DirectConnection);
 	timerProchaineCapture.setSingleShot(true);
 	timerProchaineCapture.setInterval(DUREE_ENTRE_CAPTURES);
 	qRegisterMetaType<EtatCamera>("EtatCamera");
+	qRegisterMetaType<NiveauLocalisation>("NiveauLocalisation");
 	captureEtPosition(); // Lancement de la première capture
 }
 
@@ -145,25 +248,454 @@ bool Capture::capturerImage() {
 
 
 /**
- * Etape de recherche de position
+ * Calcule la dérivée de l'image capturée dans obj_lapl (gardée d'une image à l'autre)
+ */
+void Capture::calculerObjLapl() {
+	if(obj_lapl == NULL || obj_lapl->getLignes() != img->getLignes() || obj_lapl->getColonnes() != img->getColonnes()) {
+		if(obj_lapl) delete obj_lapl;
+		obj_lapl = new Image(img->getLignes(), img->getColonnes());
+	}
+	img->convoluerParDerivee(*obj_lapl);
+}
+
+/**
+ * Etape de recherche de position ; si la dernière position est fiable, on ne cherche
+ * que dans une fenêtre autour d'elle (suivi), sinon autour du centroïde de l'image,
+ * puis sur les images réduites (pyramide), et en dernier recours dans tout l'espace de corrélation.
+ * Avec le paramètre intervalle-projections, les images entre deux de ces localisations
+ * complètes sont localisées par projections (trouverPositionParProjections).
+ * Avec le paramètre delai-localisation, une étape n'est lancée que s'il reste du temps
+ * (pour la corrélation complète, sa durée mesurée la dernière fois, qui baisse à chaque image où
+ * elle est sautée) ; à la fin du délai, on garde la meilleure estimation obtenue (pic de la
+ * pyramide, sinon centroïde), et niveauLocalisation dit laquelle (envoyé à Guidage).
+ * En mode LOCALISATION_PHASE, on mesure le décalage par rapport à l'image de référence
+ * (tant qu'il n'y en a pas, on utilise la corrélation). En mode LOCALISATION_LIMBE,
+ * on ajuste un cercle sur le limbe, en mode LOCALISATION_CHAMFER on cherche le cercle le plus
+ * proche des contours (pour ces trois modes, si le résultat n'est pas fiable, on utilise la corrélation)
  */
 void Capture::trouverPosition() {
 	if(img == NULL) {
 		return;
 	}
-	Image *obj_lapl = img->convoluerParDerivee();
-	Image *correl = obj_lapl->correlation_rapide_centree(*ref_lapl, SEUIL_CORRELATION);
-	correl->maxParInterpolation(&position_l, &position_c);
-	signalbruit = correl->calculerSignalSurBruit(position_l,position_c);
+	debutLocalisation.start();
+	niveauLocalisation = NIVEAU_AUCUN;
+	grossierValide = false;
+	calculerObjLapl();
+	centroideValide = img->calculerCentroide(SEUIL_CENTROIDE, &centroide_l, &centroide_c);
+
+	bool trouvee = false, parProjections = false;
+	if(positionValide && imagesParProjections+1 < intervalleProjections
+			&& contrasteProjections >= CONTRASTE_PROJECTIONS_MIN) {
+		trouvee = parProjections = trouverPositionParProjections();
+	}
+	if(trouvee) {
+		// Localisation économique, rien d'autre à faire
+	} else if(methodeLocalisation == LOCALISATION_PHASE) {
+		trouvee = trouverPositionParPhase();
+	} else if(methodeLocalisation == LOCALISATION_LIMBE || methodeLocalisation == LOCALISATION_LIMBE_RANSAC) {
+		trouvee = trouverPositionParLimbe();
+	} else if(methodeLocalisation == LOCALISATION_CHAMFER) {
+		trouvee = trouverPositionParChamfer();
+	}
+	if(!trouvee && tempsRestant(0)) {
+		trouvee = positionValide && demiFenetreSuivi > 0 && trouverPositionDansFenetre(demiFenetreSuivi);
+	}
+	if(!trouvee && centroideValide && tempsRestant(0)) {
+		// Pas de position pour le suivi : fenêtre autour du centroïde
+		position_l = centroide_l;
+		position_c = centroide_c;
+		trouvee = trouverPositionDansFenetre(DEMI_FENETRE_CENTROIDE);
+	}
+	if(!trouvee && rechercheBinaire && tempsRestant(0)) {
+		trouvee = trouverPositionParBinaire();
+	}
+	if(!trouvee && rechercheExacte && tempsRestant(0)) {
+		trouvee = trouverPositionParElimination();
+	}
+	if(!trouvee && niveauxPyramide > 1 && tempsRestant(0)) {
+		trouvee = trouverPositionParPyramide();
+	}
+	if(!trouvee && tempsRestant(dureeCorrelationComplete)) {
+		QTime duree;
+		duree.start();
+		Image *correl = correlateur->correler(*obj_lapl); // appartient au correlateur, ne pas supprimer
+		correl->maxParInterpolation(&position_l, &position_c);
+		signalbruit = qualiteCorrelation(correlateur, correl, correl->posMaxLigne(), correl->posMaxColonne());
+		dureeCorrelationComplete = duree.elapsed();
+		trouvee = true;
+#ifdef DEBUG
+		correl->versTiff(emplacement+"t_correl.tif");
+#endif
+	} else if(!trouvee) {
+		// Corrélation complète sautée : la durée prévue baisse pour qu'elle soit retentée (et remesurée)
+		dureeCorrelationComplete = dureeCorrelationComplete * DECROISSANCE_DUREE_CORRELATION;
+	}
+	if(trouvee) {
+		niveauLocalisation = NIVEAU_FIN;
+	} else if(grossierValide) {
+		// Délai écoulé pendant la pyramide : pic du niveau le plus fin atteint
+		position_l = grossier_l;
+		position_c = grossier_c;
+		signalbruit = grossier_signalbruit;
+		niveauLocalisation = NIVEAU_GROSSIER;
+	} else if(centroideValide) {
+		position_l = centroide_l;
+		position_c = centroide_c;
+		signalbruit = 0; // à ne pas utiliser pour le guidage
+		niveauLocalisation = NIVEAU_CENTROIDE;
+	} else {
+		signalbruit = 0;
+	}
+#ifdef DEBUG
+	if(niveauLocalisation != NIVEAU_FIN) {
+		cout << "Delai de localisation ecoule (" << debutLocalisation.elapsed() << " ms), niveau " << niveauLocalisation << endl;
+	}
+#endif
+	positionValide = niveauLocalisation >= NIVEAU_GROSSIER && signalbruit >= seuilSignalBruit;
+	if(!parProjections) {
+		mesurerContrasteProjections();
+	}
+	verifierCentroide();
 
 #ifdef DEBUG
 	img->versTiff(emplacement+"t_obj.tif");
-	correl->versTiff(emplacement+"t_correl.tif");
 	obj_lapl->versTiff(emplacement+"t_obj_lapl.tif");
 #endif
+}
+
+/**
+ * @param duree_prevue En ms, durée prévue de l'étape qu'on veut lancer
+ * @return true s'il n'y a pas de délai de localisation (paramètre delai-localisation nul)
+ * ou si l'étape peut se terminer avant la fin du délai
+ */
+bool Capture::tempsRestant(int duree_prevue) {
+	return delaiLocalisation <= 0 || debutLocalisation.elapsed() + duree_prevue < delaiLocalisation;
+}
+
+/**
+ * Localisation économique entre deux localisations complètes : corrélation des projections
+ * de obj_lapl (Projections) dans la fenêtre de suivi autour de la dernière position.
+ * Le signal/bruit est celui de la dernière localisation complète, multiplié par la perte
+ * de contraste des projections depuis (un nuage fait baisser les deux).
+ * Les projections ne pèsent pas le limbe comme la corrélation : leur position a un biais
+ * constant (une fraction de pixel, selon le diamètre), mesuré à la dernière localisation
+ * complète et retranché ici pour que la position ne saute pas d'une méthode à l'autre.
+ * L'écart avec la corrélation de la fenêtre de suivi est mesuré par l'essai "projections"
+ * de banc_essai, sur des images enregistrées.
+ * @return false si un pic touche le bord de la fenêtre ou si le signal/bruit est insuffisant :
+ * on fait alors une localisation complète
+ */
+bool Capture::trouverPositionParProjections() {
+	double l, c, contraste;
+	if(!projections->trouverPosition(*obj_lapl, position_l + biaisProjections_l, position_c + biaisProjections_c,
+			demiFenetreSuivi, &l, &c, &contraste) || contraste < CONTRASTE_PROJECTIONS_MIN) {
+		return false;
+	}
+	double qualite = signalbruitProjections * (contraste - 1) / (contrasteProjections - 1);
+	if(qualite < seuilSignalBruit) {
+		return false;
+	}
+	position_l = l - biaisProjections_l;
+	position_c = c - biaisProjections_c;
+	signalbruit = qualite;
+	imagesParProjections++;
+	return true;
+}
 
-	delete correl;
-	delete obj_lapl;
+/**
+ * Après une localisation complète fiable, mesure le contraste des projections à la position
+ * trouvée : il sert de référence au signal/bruit des images localisées par projections ;
+ * l'écart entre la position des projections et celle trouvée est leur biais
+ */
+void Capture::mesurerContrasteProjections() {
+	imagesParProjections = 0;
+	contrasteProjections = 0;
+	double l, c, contraste;
+	if(intervalleProjections > 1 && positionValide && demiFenetreSuivi > 1
+			&& projections->trouverPosition(*obj_lapl, position_l, position_c, demiFenetreSuivi, &l, &c, &contraste)) {
+		contrasteProjections = contraste;
+		signalbruitProjections = signalbruit;
+		biaisProjections_l = l - position_l;
+		biaisProjections_c = c - position_c;
+	}
+}
+
+/**
+ * Contrôle de la position trouvée : le centroïde de l'image doit en être à moins de
+ * ECART_CENTROIDE_MAX fois le diamètre. Sinon (soleil coupé par le bord de l'image, nuage
+ * épais, ou corrélation accrochée ailleurs que sur le soleil), on prévient une fois,
+ * jusqu'à ce que les deux redeviennent cohérents.
+ */
+void Capture::verifierCentroide() {
+	if(!centroideValide || !positionValide) {
+		return;
+	}
+	double ecart = sqrt((position_l - centroide_l)*(position_l - centroide_l)
+			+ (position_c - centroide_c)*(position_c - centroide_c));
+	bool incoherent = ecart > ECART_CENTROIDE_MAX * diametre;
+	if(incoherent && !centroideIncoherent) {
+		emit message("Attention : la position trouvee est a " + QString::number(ecart, 'f', 1)
+				+ " px du centre de gravite de l'image");
+	}
+	centroideIncoherent = incoherent;
+}
+
+/**
+ * Qualité d'un pic de corrélation, comparée à seuilSignalBruit : le rapport pic/lobes, ou en
+ * ZNCC le score du pic en % (entre -100 et 100)
+ * @param correl Le correlateur qui vient de calculer l'espace
+ * @param espace L'espace de corrélation (complet ou fenêtre)
+ * @param l Position du pic dans l'espace
+ * @param c
+ */
+double Capture::qualiteCorrelation(Correlateur* correl, Image* espace, int l, int c) {
+	if(normalisationCorrelation == NORMALISATION_ZNCC) {
+		return 100 * espace->getPix(l, c);
+	}
+	return correl->rapportPicLobes(l, c);
+}
+
+/**
+ * Recherche de la position dans une fenêtre de +/- demi_fenetre pixels autour de
+ * la dernière position. La corrélation est calculée sur une marge en plus (la demi-taille
+ * des lobes, Correlateur::getDemiLobes, plus un bloc de leurs sommes) pour que les lobes du
+ * rapport pic/lobes ne soient pas coupés par le bord de la fenêtre.
+ * @param demi_fenetre En px, demiFenetreSuivi pour le suivi
+ * @return false si le pic touche le bord de la fenêtre ou si le signal/bruit est
+ * insuffisant : il faut alors chercher dans tout l'espace de corrélation
+ */
+bool Capture::trouverPositionDansFenetre(int demi_fenetre) {
+	int l_suivi = position_l + 0.5, c_suivi = position_c + 0.5;
+	Image *fenetre = correlateur->correlerFenetre(*obj_lapl, l_suivi, c_suivi, demi_fenetre + correlateur->getDemiLobes() + BLOC_LOBES);
+	if(fenetre == NULL) {
+		return false;
+	}
+	int l_0 = correlateur->getFenetreLigne(), c_0 = correlateur->getFenetreColonne();
+	if(abs(l_0 + fenetre->posMaxLigne() - l_suivi) >= demi_fenetre
+			|| abs(c_0 + fenetre->posMaxColonne() - c_suivi) >= demi_fenetre) {
+#ifdef DEBUG
+		cout << "Suivi : le pic touche le bord de la fenetre, recherche dans toute l'image" << endl;
+#endif
+		return false;
+	}
+	double l, c;
+	fenetre->maxParInterpolation(&l, &c);
+	double signalbruit_fenetre = qualiteCorrelation(correlateur, fenetre, fenetre->posMaxLigne(), fenetre->posMaxColonne());
+	if(signalbruit_fenetre < seuilSignalBruit) {
+#ifdef DEBUG
+		cout << "Suivi : signal/bruit insuffisant, recherche dans toute l'image" << endl;
+#endif
+		return false;
+	}
+	position_l = l_0 + l;
+	position_c = c_0 + c;
+	signalbruit = signalbruit_fenetre;
+#ifdef DEBUG
+	fenetre->versTiff(emplacement+"t_correl.tif");
+#endif
+	return true;
+}
+
+/**
+ * Recherche "grossière puis fine" : la pyramide est faite de obj_lapl réduit par 2, 4...
+ * (Image::reduire). On cherche dans tout l'espace de corrélation du niveau le plus réduit,
+ * puis à chaque niveau plus fin on ne corrèle que +/- RAYON_AFFINAGE_PYRAMIDE pixels autour
+ * de la position du niveau précédent (multipliée par 2). Le dernier niveau (image entière)
+ * est fait comme le suivi, pour avoir la position sous-pixel et le signal/bruit.
+ * Sert au démarrage et après un passage nuageux, quand le suivi n'a pas de position fiable.
+ * @return false si l'affinage échoue (pic au bord d'une fenêtre, signal/bruit insuffisant) :
+ * il faut alors chercher dans tout l'espace de corrélation de l'image entière
+ */
+bool Capture::trouverPositionParPyramide() {
+	// Construction de la pyramide de l'objet (les images sont gardées d'une capture à l'autre)
+	Image *niveau_fin = obj_lapl;
+	for(int k=1; k < niveauxPyramide; k++) {
+		int lignes = niveau_fin->getLignes()/2, colonnes = niveau_fin->getColonnes()/2;
+		if(pyramide[k] == NULL || pyramide[k]->getLignes() != lignes || pyramide[k]->getColonnes() != colonnes) {
+			if(pyramide[k]) delete pyramide[k];
+			pyramide[k] = new Image(lignes, colonnes);
+		}
+		niveau_fin->reduire(2, *pyramide[k]);
+		niveau_fin = pyramide[k];
+	}
+
+	// Recherche complète sur le niveau le plus réduit
+	int k = niveauxPyramide-1;
+	Image *correl = correlateursPyramide[k]->correler(*pyramide[k]);
+	int l = correl->posMaxLigne(), c = correl->posMaxColonne();
+	// Estimation grossière, gardée si le délai de localisation est écoulé avant la fin : le pixel l
+	// du niveau k recouvre les pixels 2^k l à 2^k (l+1) - 1 de l'image entière
+	grossier_l = (l + 0.5) * (1 << k) - 0.5;
+	grossier_c = (c + 0.5) * (1 << k) - 0.5;
+	grossier_signalbruit = qualiteCorrelation(correlateursPyramide[k], correl, l, c);
+	grossierValide = true;
+
+	// Affinage niveau par niveau : le pixel l du niveau k recouvre les pixels 2l et 2l+1 du niveau k-1
+	for(k--; k > 0; k--) {
+		if(!tempsRestant(0)) {
+			return false;
+		}
+		int l_estime = 2*l+1, c_estime = 2*c+1;
+		Image *fenetre = correlateursPyramide[k]->correlerFenetre(*pyramide[k], l_estime, c_estime, RAYON_AFFINAGE_PYRAMIDE);
+		if(fenetre == NULL) {
+			return false;
+		}
+		l = correlateursPyramide[k]->getFenetreLigne() + fenetre->posMaxLigne();
+		c = correlateursPyramide[k]->getFenetreColonne() + fenetre->posMaxColonne();
+		if(abs(l - l_estime) >= RAYON_AFFINAGE_PYRAMIDE || abs(c - c_estime) >= RAYON_AFFINAGE_PYRAMIDE) {
+#ifdef DEBUG
+			cout << "Pyramide : le pic touche le bord de la fenetre au niveau " << k << endl;
+#endif
+			return false;
+		}
+		grossier_l = (l + 0.5) * (1 << k) - 0.5;
+		grossier_c = (c + 0.5) * (1 << k) - 0.5;
+	}
+	if(!tempsRestant(0)) {
+		return false;
+	}
+	position_l = 2*l+1;
+	position_c = 2*c+1;
+	return trouverPositionDansFenetre(RAYON_AFFINAGE_PYRAMIDE);
+}
+
+/**
+ * Recherche de la position sur toute l'image par le CorrelateurBinaire (contours et
+ * référence en bits), puis affinage par la corrélation complète dans une fenêtre de
+ * RAYON_AFFINAGE_BINAIRE px autour du pic grossier (comme la pyramide)
+ * @return false si le pic affiné touche le bord de la fenêtre ou n'a pas assez de signal/bruit
+ */
+bool Capture::trouverPositionParBinaire() {
+	int l, c, score;
+	if(!correlateurBinaire->chercher(*obj_lapl, SEUIL_CONTOUR_BINAIRE, &l, &c, &score)) {
+		return false;
+	}
+	position_l = l;
+	position_c = c;
+	return trouverPositionDansFenetre(RAYON_AFFINAGE_BINAIRE);
+}
+
+/**
+ * Recherche du maximum exact de la corrélation sur toute l'image par élimination successive
+ * (Correlateur::chercherMaximum), sans calculer tout l'espace de corrélation, puis position
+ * sous-pixel et signal/bruit par la fenêtre de suivi autour de ce maximum
+ * @return false si la recherche est abandonnée (limbe peu contrasté) ou si le signal/bruit
+ * est insuffisant
+ */
+bool Capture::trouverPositionParElimination() {
+	int l, c;
+	if(!correlateur->chercherMaximum(*obj_lapl, &l, &c)) {
+		return false;
+	}
+	position_l = l;
+	position_c = c;
+	return trouverPositionDansFenetre(RAYON_AFFINAGE_ELIMINATION);
+}
+
+/**
+ * Recherche de la position par corrélation de phase avec l'image prise au reset de la
+ * consigne (CorrelateurPhase) ; le signal/bruit est le rapport pic/lobes de l'espace de phase
+ * @return false s'il n'y a pas d'image de référence ou si le signal/bruit est inférieur à
+ * seuilSignalBruit (la dernière position est alors gardée pour le suivi)
+ */
+bool Capture::trouverPositionParPhase() {
+	double l, c, qualite;
+	if(!correlateurPhase.trouverPosition(*obj_lapl, correlateur->getDemiLobes(), correlateur->getDemiExclusion(),
+			&l, &c, &qualite) || qualite < seuilSignalBruit) {
+		return false;
+	}
+	position_l = l;
+	position_c = c;
+	signalbruit = qualite;
+	return true;
+}
+
+/**
+ * Recherche de la position par ajustement d'un cercle sur les points du limbe
+ * (Image::extrairePointsLimbe puis cercle_ajuster), en O(nombre de points du limbe).
+ * La qualité envoyée comme signal/bruit est l'inverse de l'écart-type attendu sur le
+ * centre, residu * sqrt(2/nb_points) : 10 correspond à une précision de 0.1 px.
+ * Le centre est converti en position du pic de corrélation (Correlateur::centreVersPic).
+ * En mode LOCALISATION_LIMBE_RANSAC, le cercle est cherché par cercle_ransac (les points
+ * des bords de nuages ou du bord de la coupole sont ignorés) et la qualité est le
+ * pourcentage de points du limbe cohérents avec ce cercle.
+ * @return false si l'ajustement est impossible, si la qualité est inférieure à seuilSignalBruit
+ * ou, en mode RANSAC, si moins de RATIO_INLIERS_MIN des points sont cohérents
+ */
+bool Capture::trouverPositionParLimbe() {
+	int taille = 2*(obj_lapl->getLignes() + obj_lapl->getColonnes());
+	if(limbe_taille < taille) {
+		if(limbe_l) delete [] limbe_l;
+		if(limbe_c) delete [] limbe_c;
+		limbe_l = new double[taille];
+		limbe_c = new double[taille];
+		limbe_taille = taille;
+	}
+	int n = obj_lapl->extrairePointsLimbe(SEUIL_LIMBE, PAS_LIMBE, limbe_l, limbe_c, limbe_taille);
+	Cercle cercle;
+	double qualite;
+	if(methodeLocalisation == LOCALISATION_LIMBE_RANSAC) {
+		// La cohérence est le pourcentage de points du limbe proches du cercle trouvé
+		unsigned int graine = 1; // même tirage d'une image à l'autre
+		double ratio;
+		if(!cercle_ransac(limbe_l, limbe_c, n, TOLERANCE_RANSAC, 0.45*diametre, 0.55*diametre,
+				DUREE_RANSAC, &graine, &cercle, &ratio) || ratio < RATIO_INLIERS_MIN) {
+			return false;
+		}
+		qualite = 100 * ratio;
+	} else {
+		if(!cercle_ajuster(limbe_l, limbe_c, n, &cercle)) {
+			return false;
+		}
+		qualite = 1 / (max(cercle.residu, 0.01) * sqrt(2.0/cercle.nb_points));
+	}
+	// Un seul seuil par mode : RATIO_INLIERS_MIN pour RANSAC (au dessus), seuilSignalBruit sinon
+	if(methodeLocalisation != LOCALISATION_LIMBE_RANSAC && qualite < seuilSignalBruit) {
+		return false;
+	}
+	// Même convention de position que la corrélation : pas de saut quand on passe de l'une à l'autre
+	correlateur->centreVersPic(&cercle.l, &cercle.c);
+	position_l = cercle.l;
+	position_c = cercle.c;
+	signalbruit = qualite;
+	return true;
+}
+
+/**
+ * Recherche de la position par transformée en distance des contours (Chamfer) : le
+ * centre est celui du cercle du diamètre courant le plus proche des contours de obj_lapl.
+ * Comme pour LOCALISATION_LIMBE_RANSAC, la qualité est le pourcentage de points du cercle
+ * qui sont sur un contour, et le centre est converti en position du pic de corrélation
+ * (Correlateur::centreVersPic).
+ * @return false si moins de RATIO_INLIERS_MIN du cercle est sur le limbe
+ */
+bool Capture::trouverPositionParChamfer() {
+	double l, c, ratio;
+	if(!chamfer.trouverPosition(*obj_lapl, diametre, &l, &c, &ratio) || ratio < RATIO_INLIERS_MIN) {
+		return false;
+	}
+	// Même convention de position que la corrélation (voir trouverPositionParLimbe)
+	correlateur->centreVersPic(&l, &c);
+	position_l = l;
+	position_c = c;
+	signalbruit = 100 * ratio;
+	return true;
+}
+
+/**
+ * Slot appelé au reset de la consigne : la dernière image (sa dérivée) et la dernière position
+ * deviennent la référence de la corrélation de phase
+ */
+void Capture::prendreReferencePhase() {
+	if(methodeLocalisation != LOCALISATION_PHASE) {
+		return;
+	}
+	if(obj_lapl == NULL || !positionValide) {
+		emit message("Correlation de phase : aucune position fiable pour l'image de reference");
+		return;
+	}
+	correlateurPhase.definirReference(*obj_lapl, position_l, position_c);
+	emit message("Correlation de phase : nouvelle image de reference");
 }
 
 QTime t; // pour debug de durée de correl/capture
@@ -180,7 +712,7 @@ void Capture::captureEtPosition() {
 		trouverPosition();
 		cout << "Temps ecoulé après corrélation : " << t.elapsed() << "ms" <<endl;
 		// ENVOI DES RESULTATS
-		emit resultats(imgPourAffichage,position_l,position_c,diametre,signalbruit);
+		emit resultats(imgPourAffichage,position_l,position_c,diametre,signalbruit,niveauLocalisation);
 	}
 	timerProchaineCapture.start();
 }
@@ -193,6 +725,34 @@ void Capture::modifierDiametre(int diametre) {
 	if(ref_lapl) delete ref_lapl;
 	Image *ref = Image::tracerFormeSoleil(diametre);
 	ref_lapl = ref->convoluerParDerivee();
+	if(correlateur) delete correlateur;
+	correlateur = new Correlateur(*ref_lapl, SEUIL_CORRELATION, methodeCorrelation, threadsCorrelation, precisionCorrelation,
+			normalisationCorrelation);
+	if(correlateurBinaire) delete correlateurBinaire;
+	correlateurBinaire = new CorrelateurBinaire(*ref_lapl, SEUIL_CORRELATION, threadsCorrelation);
+	if(projections) delete projections;
+	projections = new Projections(*ref_lapl, SEUIL_CORRELATION);
+	contrasteProjections = 0; // à remesurer avec le nouveau diamètre
+	dureeCorrelationComplete = 0; // idem avec le nouveau correlateur
+#ifdef DEBUG
+	// Le temps de la méthode directe (et du suivi) est proportionnel à ce nombre de points
+	cout << "Diametre " << diametre << " : " << correlateur->getNombrePoints() << " points de reference au dessus du seuil "
+			<< SEUIL_CORRELATION << " (sur " << ref_lapl->getLignes()*ref_lapl->getColonnes() << ")" << endl;
+#endif
+	// Références réduites comme les niveaux de la pyramide de l'objet
+	Image *ref_niveau = ref_lapl;
+	for(int k=1; k < NIVEAUX_PYRAMIDE_MAX; k++) {
+		if(correlateursPyramide[k]) delete correlateursPyramide[k];
+		correlateursPyramide[k] = NULL;
+		if(k < niveauxPyramide) {
+			Image *ref_reduite = ref_niveau->reduire(2);
+			correlateursPyramide[k] = new Correlateur(*ref_reduite, SEUIL_CORRELATION, methodeCorrelation, threadsCorrelation,
+					precisionCorrelation, normalisationCorrelation);
+			if(ref_niveau != ref_lapl) delete ref_niveau;
+			ref_niveau = ref_reduite;
+		}
+	}
+	if(ref_niveau != ref_lapl) delete ref_niveau;
 
 #ifdef DEBUG
 	ref->versTiff(emplacement+"t_ref.tif");
@@ -206,25 +766,55 @@ void Capture::modifierDiametre(int diametre) {
 /**
  * Recherche le meilleur diamètre pour la recherche du centre du soleil,
  * il faut avoir déjà initialisé le diametre car ne recherche qu'autour
- * du diamètre déjà présent (5 pixels autour)
+ * du diamètre déjà présent (5 pixels autour).
+ * DIAMETRE_HOUGH : le centre et le diamètre sont cherchés ensemble par la transformée
+ * de Hough (HoughCercle) en un seul passage sur le contour.
+ * DIAMETRE_CORRELATION : on garde le diamètre dont la corrélation a le meilleur
+ * signal/bruit ; les formes de chaque diamètre sont corrélées avec le même spectre
+ * de l'objet (CorrelateurMultiple).
+ * Dans les deux cas, la position est ensuite recalculée une fois avec le nouveau diamètre.
  * @return le diamètre
  */
 int Capture::chercherDiametreProche() {
-	double signalbruit_max = 0; // On recherche le meilleur signal/bruit possible
-	double diametre_optimise;
-	Image* ref;
-	for(int diam = diametre-5; diam < diametre+5; diam++) {
-		ref = Image::tracerFormeSoleil(diam);
-		if(ref_lapl) delete ref_lapl;
-		ref_lapl = ref->convoluerParDerivee();
-		delete ref;
-		trouverPosition();
-		if(signalbruit > signalbruit_max) {
-			signalbruit_max = signalbruit;
-			diametre_optimise = diam;
+	if(img == NULL) {
+		return diametre;
+	}
+	int diametre_optimise = diametre;
+	if(rechercheDiametre == DIAMETRE_HOUGH) {
+		if(hough == NULL) {
+			hough = new HoughCercle(threadsCorrelation);
+		}
+		double l, c, diametre_trouve, score;
+		if(!hough->chercher(*img, diametre-5, diametre+5, 1, &l, &c, &diametre_trouve, &score)) {
+			return diametre;
+		}
+		diametre_optimise = (int)(diametre_trouve + 0.5);
+#ifdef DEBUG
+		cout << "Hough : centre (" << l << ", " << c << "), diametre " << diametre_trouve << " px, score " << score << endl;
+#endif
+	} else {
+		const int nb_diametres = 11;
+		Image* references[nb_diametres];
+		ResultatCorrelation resultats[nb_diametres];
+		for(int k=0; k < nb_diametres; k++) {
+			Image *forme = Image::tracerFormeSoleil(diametre-5+k);
+			references[k] = forme->convoluerParDerivee();
+			delete forme;
+		}
+		CorrelateurMultiple correlateurs(references, nb_diametres, SEUIL_CORRELATION, threadsCorrelation);
+		calculerObjLapl();
+		correlateurs.correler(*obj_lapl, resultats);
+		double signalbruit_max = 0; // On recherche le meilleur signal/bruit possible
+		for(int k=0; k < nb_diametres; k++) {
+			if(resultats[k].signalbruit > signalbruit_max) {
+				signalbruit_max = resultats[k].signalbruit;
+				diametre_optimise = diametre-5+k;
+			}
+			delete references[k];
 		}
 	}
 	emit diametreSoleil(diametre_optimise);
 	modifierDiametre(diametre_optimise);
+	trouverPosition();
 	return diametre_optimise;
 }
@@ -18,6 +18,21 @@
 // Paramètres "en dur" ne pouvant être modifiés que par la recompilation :
 #define SEUIL_CORRELATION		0.90 	// entre 0 et 1 (% du max de ref) au dessus duquel les valeurs de ref. sont correlées
 #define DUREE_ENTRE_CAPTURES 	1000 	// en ms, il faut aussi compter le temps passé à capturer ! (1100ms environ)
+#define NIVEAUX_PYRAMIDE_MAX	4		// nombre maximal de niveaux de la pyramide (niveau 0 = image entière)
+#define RAYON_AFFINAGE_PYRAMIDE	4		// en px, demi-taille de la fenêtre d'affinage à chaque niveau de la pyramide
+#define SEUIL_LIMBE				0.3		// entre 0 et 1 (% du max de la dérivée) au dessus duquel un pixel est sur le limbe
+#define PAS_LIMBE				2		// en px, écart entre deux lignes (ou colonnes) où on cherche le limbe
+#define TOLERANCE_RANSAC		1.5		// en px, distance maximale au cercle d'un point du limbe "cohérent" (inlier)
+#define DUREE_RANSAC			0.005	// en s, temps maximal passé à tirer des cercles (RANSAC)
+#define DECROISSANCE_DUREE_CORRELATION	0.75	// facteur appliqué à la durée prévue de la corrélation complète quand elle est sautée
+#define SEUIL_CONTOUR_BINAIRE	0.3		// entre 0 et 1 (% du max de la dérivée) au dessus duquel un pixel est un contour (recherche binaire)
+#define RAYON_AFFINAGE_BINAIRE	4		// en px, demi-taille de la fenêtre d'affinage du pic de la recherche binaire
+#define RAYON_AFFINAGE_ELIMINATION	2	// en px, demi-taille de la fenêtre d'affinage du maximum exact (élimination successive)
+#define SEUIL_CENTROIDE			0.5		// entre 0 et 1 (entre le fond et le max de l'image) au dessus duquel un pixel compte dans le centroïde
+#define DEMI_FENETRE_CENTROIDE	10		// en px, demi-taille de la fenêtre de recherche autour du centroïde
+#define ECART_CENTROIDE_MAX		0.1		// fraction du diamètre, écart centroïde/position au delà duquel on prévient
+#define RATIO_INLIERS_MIN		0.5		// entre 0 et 1, proportion des points du limbe qui doivent être cohérents
+#define CONTRASTE_PROJECTIONS_MIN	1.05	// contraste des projections (pic / moyenne) en dessous duquel on ne s'y fie pas (bruit seul : 1.01 au plus)
 
 #include "camera.h"
 #include "camera_fake.h"
@@ -30,10 +45,20 @@
 #include <QtCore/QMetaType>
 #include <QtGui/QImage>
 #include <QtCore/QSettings>
+#include <QtCore/QThread>
 // Les paramètres sont enregistrés (sous Linux) dans ~/.config/irap/climso-auto.conf
 
 #include "diametre_soleil.h"
 #include "image.h"
+#include "correlateur.h"
+#include "correlateur_phase.h"
+#include "cercle.h"
+#include "hough.h"
+#include "correlateur_multiple.h"
+#include "correlateur_binaire.h"
+#include "chamfer.h"
+#include "projections.h"
+#include "niveau_localisation.h"
 #include "config.h"
 
 // ACTIVER LE DEBUG: ./configure CPPFLAGS="-DDEBUG=1" (si autotools) ou gcc -DDEBUG=1 sinon
@@ -41,6 +66,19 @@
 static string emplacement = ""; // Emplacement des images du debug caméra et corrélation (et laplacien)
 #endif
 
+typedef enum {
+	LOCALISATION_CORRELATION,	// Corrélation avec la forme théorique du soleil (suivi, pyramide, image entière)
+	LOCALISATION_PHASE,			// Corrélation de phase avec l'image prise au reset de la consigne
+	LOCALISATION_LIMBE,			// Ajustement d'un cercle sur les points du limbe
+	LOCALISATION_LIMBE_RANSAC,	// Idem, robuste aux points hors du limbe (nuages, soleil tronqué)
+	LOCALISATION_CHAMFER		// Distance moyenne (plafonnée) d'un cercle aux contours de l'image
+} MethodeLocalisation;
+
+typedef enum {
+	DIAMETRE_HOUGH,				// Transformée de Hough (centre et diamètre en un passage)
+	DIAMETRE_CORRELATION		// Corrélation avec la forme du soleil pour chaque diamètre (CorrelateurMultiple)
+} RechercheDiametre;
+
 typedef enum {
 	CAMERA_CONNEXION_ON,
 	CAMERA_CONNEXION_OFF
@@ -60,13 +98,62 @@ private:
 #endif
 	Image* img;
 	Image* ref_lapl;// laplacien de la ref de l'image du soleil
+	Image* obj_lapl;// laplacien de l'image capturée (gardé d'une image à l'autre)
+	Correlateur* correlateur; // reconstruit à chaque modification du diamètre
+	Correlateur* correlateursPyramide[NIVEAUX_PYRAMIDE_MAX]; // un par niveau réduit (l'indice 0 n'est pas utilisé)
+	Image* pyramide[NIVEAUX_PYRAMIDE_MAX]; // obj_lapl réduit par 2^k au niveau k (l'indice 0 n'est pas utilisé)
+	int niveauxPyramide; // Paramètre (1 pour toujours chercher sur l'image entière)
+	ThreadsCalcul* threadsCorrelation; // partagés par tous les correlateurs
+	CorrelateurBinaire* correlateurBinaire; // reconstruit à chaque modification du diamètre
+	bool rechercheBinaire; // Paramètre (recherche grossière sur les contours binaires avant la pyramide)
+	bool rechercheExacte; // Paramètre (maximum exact par élimination successive avant la pyramide)
+	Projections* projections; // reconstruit à chaque modification du diamètre
+	int intervalleProjections; // Paramètre (une localisation complète toutes les N images, 0 ou 1 : jamais de projections)
+	int imagesParProjections; // Images localisées par projections depuis la dernière localisation complète
+	double contrasteProjections, signalbruitProjections; // Mesurés à la dernière localisation complète
+	double biaisProjections_l, biaisProjections_c; // Position des projections moins celle de la dernière localisation complète
+	int delaiLocalisation; // Paramètre, en ms après la lecture de l'image (0 : pas de délai)
+	QTime debutLocalisation;
+	int dureeCorrelationComplete; // en ms, mesurée à la dernière corrélation complète (baisse quand elle est sautée)
+	NiveauLocalisation niveauLocalisation; // Niveau atteint par la dernière localisation
+	double grossier_l, grossier_c, grossier_signalbruit; // Dernière estimation de la pyramide
+	bool grossierValide;
+	MethodeLocalisation methodeLocalisation; // Paramètre
+	CorrelateurPhase correlateurPhase;
+	double *limbe_l, *limbe_c; // Points du limbe (LOCALISATION_LIMBE et LOCALISATION_LIMBE_RANSAC)
+	int limbe_taille;
+	Chamfer chamfer; // LOCALISATION_CHAMFER
+	MethodeCorrelation methodeCorrelation; // Paramètre
+	PrecisionCorrelation precisionCorrelation; // Paramètre
+	NormalisationCorrelation normalisationCorrelation; // Paramètre
+	RechercheDiametre rechercheDiametre; // Paramètre
+	HoughCercle* hough; // DIAMETRE_HOUGH, gardé (avec ses accumulateurs) d'une recherche à l'autre
 	QImage imgPourAffichage; // Image non binnée pour envoi à Guidage
 	int diametre; 	// diametre du soleil en pixels
     double position_l;
     double position_c;
-    double signalbruit;
+    double signalbruit; // Rapport pic/lobes de la corrélation (qualiteCorrelation) ou qualité de la localisation
+    bool positionValide; // La dernière position a un signal/bruit suffisant pour servir au suivi
+    double centroide_l, centroide_c; // Centre de gravité de l'image capturée (point de départ de la recherche)
+    bool centroideValide;
+    bool centroideIncoherent; // Le centroïde est loin de la position trouvée (message déjà envoyé)
+    int demiFenetreSuivi; // Paramètre, en px (0 pour toujours chercher dans toute l'image)
+    double seuilSignalBruit; // Paramètre (le même que pour Guidage)
     bool normaliserImageAffichee;
     QImage versQImage(Image*);
+    void calculerObjLapl();
+    void verifierCentroide();
+    bool tempsRestant(int duree_prevue);
+    bool trouverPositionDansFenetre(int demi_fenetre);
+    bool trouverPositionParPyramide();
+    double qualiteCorrelation(Correlateur* correl, Image* espace, int l, int c);
+    bool trouverPositionParBinaire();
+    bool trouverPositionParElimination();
+    bool trouverPositionParProjections();
+    void mesurerContrasteProjections();
+    bool trouverPositionParPhase();
+    bool trouverPositionParLimbe();
+    bool trouverPositionParChamfer();
     EtatCamera etatCamera;
 public:
 	Capture();
@@ -80,6 +167,7 @@ public slots:
 	void enregistrerParametres();
 	void chargerParametres();
 	int chercherDiametreProche();
+	void prendreReferencePhase();
 private slots:
 	void connexionAuto();
 	void captureEtPosition();
@@ -87,7 +175,7 @@ signals:
 	void message(QString);
 	void stopperGuidage();
 	void envoiEtatCamera(EtatCamera);
-	void resultats(QImage img, double l, double c, int diametre, double bruitsignal);
+	void resultats(QImage img, double l, double c, int diametre, double bruitsignal, NiveauLocalisation niveau);
 	void diametreSoleil(int);
 };
 
@@ -0,0 +1,304 @@
+//
+//  cercle.c
+//  climso-auto
+//
+//  Ajustement d'un cercle aux moindres carrés sur des points du limbe :
+//  - ajustement algébrique de Kåsa (résolution d'un système linéaire 3x3), rapide
+//    mais légèrement biaisé quand les points ne couvrent qu'une partie du cercle ;
+//  - puis ajustement géométrique par Gauss-Newton (minimise la somme des carrés des
+//    distances des points au cercle), en partant du résultat de Kåsa ;
+//  - RANSAC quand une partie des points n'est pas sur le limbe (nuages, bord de
+//    la coupole) : cercles passant par trois points tirés au hasard, on garde celui
+//    qui a le plus de points proches (inliers) puis on l'ajuste sur ces points.
+//
+
+#define _POSIX_C_SOURCE 199309L	// clock_gettime() même en -std=c99
+#include <math.h>
+#include <time.h>
+#include "cercle.h"
+
+/**
+ * Résout le système 3x3 a.x = b par la méthode de Cramer
+ * @return 0 si le système est singulier, 1 sinon
+ */
+static int resoudre_3x3(double a[3][3], const double b[3], double x[3]) {
+	double det = a[0][0]*(a[1][1]*a[2][2] - a[1][2]*a[2][1])
+			- a[0][1]*(a[1][0]*a[2][2] - a[1][2]*a[2][0])
+			+ a[0][2]*(a[1][0]*a[2][1] - a[1][1]*a[2][0]);
+	int k;
+	if(fabs(det) < 1e-12)
+		return 0;
+	for(k=0; k < 3; k++) {
+		double m[3][3];
+		int i, j;
+		for(i=0; i < 3; i++)
+			for(j=0; j < 3; j++)
+				m[i][j] = (j == k) ? b[i] : a[i][j];
+		x[k] = (m[0][0]*(m[1][1]*m[2][2] - m[1][2]*m[2][1])
+				- m[0][1]*(m[1][0]*m[2][2] - m[1][2]*m[2][0])
+				+ m[0][2]*(m[1][0]*m[2][1] - m[1][1]*m[2][0])) / det;
+	}
+	return 1;
+}
+
+/**
+ * Ajustement algébrique de Kåsa : on cherche D, E, F minimisant la somme des
+ * (l² + c² + D.l + E.c + F)². Les coordonnées sont centrées sur la moyenne des
+ * points pour que le système soit bien conditionné.
+ * @param l Coordonnées des points
+ * @param c
+ * @param n Nombre de points (au moins 3)
+ * @param cercle Le résultat
+ * @return 0 si l'ajustement est impossible (moins de 3 points, points alignés, rayon² non
+ * positif ou non fini), 1 sinon
+ */
+int cercle_kasa(const double *l, const double *c, int n, Cercle *cercle) {
+	double l_moy = 0, c_moy = 0;
+	double a[3][3] = {{0,0,0},{0,0,0},{0,0,0}}, b[3] = {0,0,0}, x[3], r2;
+	int i;
+	if(n < 3)
+		return 0;
+	for(i=0; i < n; i++) {
+		l_moy += l[i];
+		c_moy += c[i];
+	}
+	l_moy /= n;
+	c_moy /= n;
+	for(i=0; i < n; i++) {
+		double u = l[i] - l_moy, v = c[i] - c_moy, z = u*u + v*v;
+		a[0][0] += u*u; a[0][1] += u*v; a[0][2] += u;
+		a[1][1] += v*v; a[1][2] += v;
+		b[0] -= u*z; b[1] -= v*z; b[2] -= z;
+	}
+	a[1][0] = a[0][1]; a[2][0] = a[0][2]; a[2][1] = a[1][2]; a[2][2] = n;
+	if(!resoudre_3x3(a, b, x))
+		return 0;
+	// r² négatif ou nul (points presque alignés, ou valeurs aberrantes) : pas de cercle
+	r2 = x[0]*x[0]/4 + x[1]*x[1]/4 - x[2];
+	if(!(r2 > 0) || !isfinite(r2))
+		return 0;
+	cercle->l = l_moy - x[0]/2;
+	cercle->c = c_moy - x[1]/2;
+	cercle->rayon = sqrt(r2);
+	cercle->nb_points = n;
+	cercle->residu = cercle_residu(l, c, n, cercle);
+	return 1;
+}
+
+/**
+ * Ajustement géométrique par Gauss-Newton : minimise la somme des (d_i - r)² où d_i est
+ * la distance du point i au centre
+ * @param l Coordonnées des points
+ * @param c
+ * @param n Nombre de points (au moins 3)
+ * @param iterations Nombre maximal d'itérations
+ * @param cercle Le cercle de départ (Kåsa par exemple), remplacé par le résultat
+ * @return 0 si l'ajustement a échoué (cercle inchangé), 1 sinon
+ */
+int cercle_gauss_newton(const double *l, const double *c, int n, int iterations, Cercle *cercle) {
+	double a0 = cercle->l, b0 = cercle->c, r0 = cercle->rayon;
+	int it, i;
+	if(n < 3)
+		return 0;
+	for(it=0; it < iterations; it++) {
+		// Système normal J^t.J.delta = -J^t.residus, avec J la jacobienne des (d_i - r)
+		double jtj[3][3] = {{0,0,0},{0,0,0},{0,0,0}}, jtr[3] = {0,0,0}, delta[3];
+		for(i=0; i < n; i++) {
+			double dl = l[i] - a0, dc = c[i] - b0;
+			double d = sqrt(dl*dl + dc*dc);
+			double j[3], res;
+			if(d < 1e-9)
+				continue;
+			j[0] = -dl/d; j[1] = -dc/d; j[2] = -1;
+			res = d - r0;
+			jtj[0][0] += j[0]*j[0]; jtj[0][1] += j[0]*j[1]; jtj[0][2] += j[0]*j[2];
+			jtj[1][1] += j[1]*j[1]; jtj[1][2] += j[1]*j[2];
+			jtj[2][2] += j[2]*j[2];
+			jtr[0] -= j[0]*res; jtr[1] -= j[1]*res; jtr[2] -= j[2]*res;
+		}
+		jtj[1][0] = jtj[0][1]; jtj[2][0] = jtj[0][2]; jtj[2][1] = jtj[1][2];
+		if(!resoudre_3x3(jtj, jtr, delta))
+			return 0;
+		a0 += delta[0];
+		b0 += delta[1];
+		r0 += delta[2];
+		if(fabs(delta[0]) + fabs(delta[1]) + fabs(delta[2]) < 1e-6)
+			break;
+	}
+	cercle->l = a0;
+	cercle->c = b0;
+	cercle->rayon = r0;
+	cercle->nb_points = n;
+	cercle->residu = cercle_residu(l, c, n, cercle);
+	return 1;
+}
+
+/**
+ * @return La moyenne quadratique des distances des points au cercle
+ */
+double cercle_residu(const double *l, const double *c, int n, const Cercle *cercle) {
+	double somme = 0;
+	int i;
+	if(n < 1)
+		return 0;
+	for(i=0; i < n; i++) {
+		double dl = l[i] - cercle->l, dc = c[i] - cercle->c;
+		double e = sqrt(dl*dl + dc*dc) - cercle->rayon;
+		somme += e*e;
+	}
+	return sqrt(somme/n);
+}
+
+/**
+ * Ajustement complet : Kåsa puis Gauss-Newton. Les points à plus de 3 fois le résidu
+ * (et plus de 1 px) du cercle trouvé sont retirés, puis on recommence (3 fois au plus).
+ * @param l Coordonnées des points ; les points gardés sont regroupés au début des tableaux
+ * @param c
+ * @param n
+ * @param cercle Le résultat (cercle->nb_points est le nombre de points gardés)
+ * @return 0 si l'ajustement est impossible, 1 sinon
+ */
+int cercle_ajuster(double *l, double *c, int n, Cercle *cercle) {
+	int passe, i, gardes;
+	if(!cercle_kasa(l, c, n, cercle))
+		return 0;
+	cercle_gauss_newton(l, c, n, 10, cercle);
+	for(passe=0; passe < 3; passe++) {
+		double limite = 3*cercle->residu;
+		if(limite < 1)
+			limite = 1;
+		for(i=0, gardes=0; i < n; i++) {
+			double dl = l[i] - cercle->l, dc = c[i] - cercle->c;
+			if(fabs(sqrt(dl*dl + dc*dc) - cercle->rayon) <= limite) {
+				l[gardes] = l[i];
+				c[gardes] = c[i];
+				gardes++;
+			}
+		}
+		if(gardes == n)
+			break;
+		n = gardes;
+		if(!cercle_kasa(l, c, n, cercle))
+			return 0;
+		cercle_gauss_newton(l, c, n, 10, cercle);
+	}
+	return 1;
+}
+
+/**
+ * Cercle passant par trois points
+ * @return 0 si les points sont alignés, 1 sinon
+ */
+int cercle_par_trois_points(double l1, double c1, double l2, double c2, double l3, double c3, Cercle *cercle) {
+	double a = l2 - l1, b = c2 - c1, e = l3 - l1, f = c3 - c1;
+	double g = 2*(a*f - b*e);
+	double p, q;
+	if(fabs(g) < 1e-9)
+		return 0;
+	p = a*a + b*b;
+	q = e*e + f*f;
+	cercle->l = l1 + (f*p - b*q)/g;
+	cercle->c = c1 + (a*q - e*p)/g;
+	cercle->rayon = sqrt((cercle->l - l1)*(cercle->l - l1) + (cercle->c - c1)*(cercle->c - c1));
+	cercle->nb_points = 3;
+	cercle->residu = 0;
+	return 1;
+}
+
+/**
+ * Générateur pseudo-aléatoire (congruentiel linéaire) : le tirage ne dépend que de la graine
+ */
+static int aleatoire(unsigned int *graine, int n) {
+	*graine = *graine * 1103515245u + 12345u;
+	return (int)((*graine >> 8) % (unsigned int)n);
+}
+
+/**
+ * @return Le temps de l'horloge monotone (temps réel écoulé, et non temps processeur), en s
+ */
+static double secondes_monotones(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+/**
+ * @return Le nombre de points à moins de "tolerance" du cercle
+ */
+static int compter_inliers(const double *l, const double *c, int n, const Cercle *cercle, double tolerance) {
+	int i, compte = 0;
+	for(i=0; i < n; i++) {
+		double dl = l[i] - cercle->l, dc = c[i] - cercle->c;
+		if(fabs(sqrt(dl*dl + dc*dc) - cercle->rayon) <= tolerance)
+			compte++;
+	}
+	return compte;
+}
+
+/**
+ * Ajustement robuste (RANSAC) : tant que la durée maximale n'est pas dépassée, on tire trois
+ * points, on calcule le cercle qui passe par eux et on compte ses inliers. Le meilleur cercle
+ * est ensuite ajusté (Kåsa puis Gauss-Newton) sur ses inliers ; si cet ajustement diverge
+ * (non fini, rayon hors limites, ou résidu sur les inliers plus grand que celui du cercle tiré),
+ * le cercle tiré est gardé.
+ * @param l Coordonnées des points ; les inliers sont regroupés au début des tableaux
+ * @param c
+ * @param n Nombre de points
+ * @param tolerance Distance maximale (px) d'un inlier au cercle
+ * @param rayon_min Les cercles tirés en dehors de [rayon_min, rayon_max] sont ignorés
+ * @param rayon_max
+ * @param duree_max Durée maximale des tirages, en secondes (horloge monotone : clock() compterait
+ * aussi le temps des threads de calcul)
+ * @param graine Graine du générateur pseudo-aléatoire (modifiée)
+ * @param cercle Le résultat
+ * @param ratio_inliers Proportion des points qui sont des inliers du résultat (cohérence)
+ * @return 0 si aucun cercle n'a été trouvé, 1 sinon
+ */
+int cercle_ransac(double *l, double *c, int n, double tolerance, double rayon_min, double rayon_max,
+		double duree_max, unsigned int *graine, Cercle *cercle, double *ratio_inliers) {
+	const int iterations_min = 20;
+	double limite = secondes_monotones() + duree_max;
+	Cercle essai, meilleur;
+	int meilleur_compte = 0, iteration, i, gardes;
+	*ratio_inliers = 0;
+	if(n < 3)
+		return 0;
+	for(iteration=0; iteration < iterations_min || secondes_monotones() < limite; iteration++) {
+		int i1 = aleatoire(graine, n), i2 = aleatoire(graine, n), i3 = aleatoire(graine, n);
+		int compte;
+		if(i1 == i2 || i1 == i3 || i2 == i3)
+			continue;
+		if(!cercle_par_trois_points(l[i1], c[i1], l[i2], c[i2], l[i3], c[i3], &essai))
+			continue;
+		if(essai.rayon < rayon_min || essai.rayon > rayon_max)
+			continue;
+		compte = compter_inliers(l, c, n, &essai, tolerance);
+		if(compte > meilleur_compte) {
+			meilleur_compte = compte;
+			meilleur = essai;
+			if(compte == n)
+				break;
+		}
+	}
+	if(meilleur_compte < 3)
+		return 0;
+	// Ajustement sur les inliers du meilleur cercle
+	for(i=0, gardes=0; i < n; i++) {
+		double dl = l[i] - meilleur.l, dc = c[i] - meilleur.c;
+		if(fabs(sqrt(dl*dl + dc*dc) - meilleur.rayon) <= tolerance) {
+			l[gardes] = l[i];
+			c[gardes] = c[i];
+			gardes++;
+		}
+	}
+	*cercle = meilleur;
+	if(cercle_kasa(l, c, gardes, &essai) && cercle_gauss_newton(l, c, gardes, 10, &essai)
+			&& isfinite(essai.l) && isfinite(essai.c) && isfinite(essai.rayon)
+			&& essai.rayon >= rayon_min && essai.rayon <= rayon_max
+			&& cercle_residu(l, c, gardes, &essai) <= cercle_residu(l, c, gardes, &meilleur))
+		*cercle = essai;
+	cercle->nb_points = gardes;
+	cercle->residu = cercle_residu(l, c, gardes, cercle);
+	*ratio_inliers = (double)gardes / n;
+	return 1;
+}
@@ -0,0 +1,34 @@
+//
+//  cercle.h
+//  climso-auto
+//
+//  Ajustement d'un cercle sur des points du limbe solaire (voir Image::extrairePointsLimbe)
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef climso_auto_cercle_h
+#define climso_auto_cercle_h
+
+typedef struct {
+	double l, c;		// centre (ligne, colonne)
+	double rayon;
+	double residu;		// moyenne quadratique des distances des points au cercle, en px
+	int nb_points;		// nombre de points utilisés pour l'ajustement
+} Cercle;
+
+int cercle_kasa(const double *l, const double *c, int n, Cercle *cercle);
+int cercle_gauss_newton(const double *l, const double *c, int n, int iterations, Cercle *cercle);
+double cercle_residu(const double *l, const double *c, int n, const Cercle *cercle);
+int cercle_ajuster(double *l, double *c, int n, Cercle *cercle);
+int cercle_par_trois_points(double l1, double c1, double l2, double c2, double l3, double c3, Cercle *cercle);
+int cercle_ransac(double *l, double *c, int n, double tolerance, double rayon_min, double rayon_max,
+		double duree_max, unsigned int *graine, Cercle *cercle, double *ratio_inliers);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,281 @@
+/*
+ * chamfer.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Transformée en distance euclidienne exacte en deux passages 1D (colonnes puis lignes),
+ *  chacun en temps linéaire : enveloppe inférieure des paraboles (Felzenszwalb et
+ *  Huttenlocher, "Distance Transforms of Sampled Functions").
+ *
+ *  Recherche du centre : note de tous les centres d'une grille de PAS_GRILLE_CHAMFER px
+ *  (les distances variant lentement, le bassin du minimum fait DISTANCE_MAX_CHAMFER px),
+ *  descente pixel par pixel depuis le meilleur, puis grille fine (cercle non arrondi,
+ *  distances interpolées) à plus ou moins un pixel.
+ */
+
+#include "chamfer.h"
+#include <cmath>
+
+#define INFINI_CHAMFER	1e20
+
+Chamfer::Chamfer() {
+	lignes = colonnes = 0;
+	marge = lignes_dist = colonnes_dist = 0;
+	distances = NULL;
+	f = d = z = NULL;
+	v = NULL;
+	cercle_l = cercle_c = NULL;
+	sinus = cosinus = NULL;
+	nb_points_cercle = diametre_cercle = nb_angles_cercle = 0;
+}
+
+Chamfer::~Chamfer() {
+	liberer();
+}
+
+void Chamfer::liberer() {
+	if(distances) delete [] distances;
+	if(f) delete [] f;
+	if(d) delete [] d;
+	if(z) delete [] z;
+	if(v) delete [] v;
+	if(cercle_l) delete [] cercle_l;
+	if(cercle_c) delete [] cercle_c;
+	if(sinus) delete [] sinus;
+	if(cosinus) delete [] cosinus;
+	sinus = cosinus = NULL;
+	distances = NULL;
+	f = d = z = NULL;
+	v = NULL;
+	cercle_l = cercle_c = NULL;
+	lignes = colonnes = 0;
+	nb_points_cercle = diametre_cercle = nb_angles_cercle = 0;
+}
+
+/**
+ * Alloue les espaces de travail et les points du cercle ; ne fait rien si la taille des
+ * images et le diamètre n'ont pas changé
+ */
+void Chamfer::preparer(int lignes, int colonnes, int diametre) {
+	if(lignes == this->lignes && colonnes == this->colonnes && diametre == diametre_cercle) {
+		return;
+	}
+	liberer();
+	this->lignes = lignes;
+	this->colonnes = colonnes;
+	diametre_cercle = diametre;
+	// Un cercle centré n'importe où dans l'image reste dans la carte des distances
+	marge = diametre/2 + 3;
+	lignes_dist = lignes + 2*marge;
+	colonnes_dist = colonnes + 2*marge;
+	distances = new MonDouble[lignes_dist*colonnes_dist];
+	int n = max(lignes_dist, colonnes_dist);
+	f = new double[n];
+	d = new double[n];
+	z = new double[n+1];
+	v = new int[n];
+	// Points du cercle espacés d'environ un pixel (sans doublon consécutif)
+	double rayon = diametre/2.0;
+	int nb_angles = max(8, (int)(2*M_PI*rayon));
+	cercle_l = new int[nb_angles];
+	cercle_c = new int[nb_angles];
+	sinus = new double[nb_angles];
+	cosinus = new double[nb_angles];
+	nb_angles_cercle = nb_angles;
+	nb_points_cercle = 0;
+	for (int i=0; i < nb_angles; i++) {
+		double angle = 2*M_PI*i/nb_angles;
+		sinus[i] = sin(angle);
+		cosinus[i] = cos(angle);
+		int l = (int)floor(rayon*sinus[i] + 0.5), c = (int)floor(rayon*cosinus[i] + 0.5);
+		if(nb_points_cercle > 0 && l == cercle_l[nb_points_cercle-1] && c == cercle_c[nb_points_cercle-1]) {
+			continue;
+		}
+		cercle_l[nb_points_cercle] = l;
+		cercle_c[nb_points_cercle] = c;
+		nb_points_cercle++;
+	}
+}
+
+/**
+ * Transformée en distance (au carré) 1D de f[0..n-1] dans d[0..n-1] :
+ * d[q] = min sur p de (q-p)^2 + f[p]
+ */
+void Chamfer::distance1D(int n) {
+	int k = 0;
+	v[0] = 0;
+	z[0] = -INFINI_CHAMFER;
+	z[1] = INFINI_CHAMFER;
+	for (int q=1; q < n; q++) {
+		double s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+		while(s <= z[k]) {
+			k--;
+			s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / (2*q - 2*v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k+1] = INFINI_CHAMFER;
+	}
+	k = 0;
+	for (int q=0; q < n; q++) {
+		while(z[k+1] < q) k++;
+		d[q] = (q - v[k])*(q - v[k]) + f[v[k]];
+	}
+}
+
+/**
+ * Distance de chaque pixel au contour le plus proche, plafonnée à DISTANCE_MAX_CHAMFER.
+ * Les contours sont les pixels de la dérivée au dessus de seuil_relatif fois son maximum
+ * (et d'au moins 3 fois sa moyenne, celle du bruit), comme pour Image::extrairePointsLimbe.
+ */
+void Chamfer::calculerDistances(Image& obj, double seuil_relatif) {
+	const MonDouble* p = obj.ptr();
+	double somme = 0;
+	for (int i=0; i < lignes*colonnes; i++) {
+		somme += p[i];
+	}
+	MonDouble seuil = max(seuil_relatif * obj.valeurMax(), 3 * somme/(lignes*colonnes));
+	for (int l=0; l < lignes_dist; l++) {
+		for (int c=0; c < colonnes_dist; c++) {
+			int l_obj = l - marge, c_obj = c - marge;
+			bool contour = l_obj >= 0 && l_obj < lignes && c_obj >= 0 && c_obj < colonnes
+					&& p[l_obj*colonnes + c_obj] > seuil;
+			distances[l*colonnes_dist + c] = contour ? 0 : INFINI_CHAMFER;
+		}
+	}
+	for (int c=0; c < colonnes_dist; c++) {
+		for (int l=0; l < lignes_dist; l++) f[l] = distances[l*colonnes_dist + c];
+		distance1D(lignes_dist);
+		for (int l=0; l < lignes_dist; l++) distances[l*colonnes_dist + c] = d[l];
+	}
+	for (int l=0; l < lignes_dist; l++) {
+		MonDouble* ligne = distances + l*colonnes_dist;
+		for (int c=0; c < colonnes_dist; c++) f[c] = ligne[c];
+		distance1D(colonnes_dist);
+		for (int c=0; c < colonnes_dist; c++) ligne[c] = min(sqrt(d[c]), (double)DISTANCE_MAX_CHAMFER);
+	}
+}
+
+/**
+ * @return La moyenne des distances au contour des points du cercle centré en (l,c)
+ */
+double Chamfer::score(int l, int c) {
+	const MonDouble* centre = distances + (l + marge)*colonnes_dist + c + marge;
+	double somme = 0;
+	for (int i=0; i < nb_points_cercle; i++) {
+		somme += centre[cercle_l[i]*colonnes_dist + cercle_c[i]];
+	}
+	return somme / nb_points_cercle;
+}
+
+/**
+ * Comme score() mais pour un centre sous-pixel : les points du cercle ne sont pas arrondis
+ * et les distances sont interpolées (bilinéaire)
+ */
+double Chamfer::scoreSousPixel(double l, double c) {
+	double rayon = diametre_cercle/2.0;
+	double somme = 0;
+	for (int i=0; i < nb_angles_cercle; i++) {
+		double l_point = l + marge + rayon*sinus[i], c_point = c + marge + rayon*cosinus[i];
+		int l0 = (int)l_point, c0 = (int)c_point; // positifs grâce à la marge
+		double fl = l_point - l0, fc = c_point - c0;
+		const MonDouble* p = distances + l0*colonnes_dist + c0;
+		somme += (1-fl)*((1-fc)*p[0] + fc*p[1]) + fl*((1-fc)*p[colonnes_dist] + fc*p[colonnes_dist+1]);
+	}
+	return somme / nb_angles_cercle;
+}
+
+/**
+ * Position du soleil : centre du cercle de diamètre "diametre" le plus proche des contours
+ * @param obj La dérivée de l'image capturée (convoluerParDerivee)
+ * @param diametre
+ * @param l Position trouvée
+ * @param c
+ * @param ratio_limbe Proportion des points du cercle à moins de DISTANCE_PROCHE_CHAMFER px
+ * d'un contour (1 pour un limbe entier, moins s'il est en partie caché)
+ * @return false s'il n'y a aucun contour dans l'image
+ */
+bool Chamfer::trouverPosition(Image& obj, int diametre, double *l, double *c, double *ratio_limbe) {
+	preparer(obj.getLignes(), obj.getColonnes(), diametre);
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	calculerDistances(obj, SEUIL_CONTOUR_CHAMFER);
+	// Grille grossière
+	int l_min = 0, c_min = 0;
+	double score_min = INFINI_CHAMFER;
+	for (int l_grille = PAS_GRILLE_CHAMFER/2; l_grille < lignes; l_grille += PAS_GRILLE_CHAMFER) {
+		for (int c_grille = PAS_GRILLE_CHAMFER/2; c_grille < colonnes; c_grille += PAS_GRILLE_CHAMFER) {
+			double s = score(l_grille, c_grille);
+			if(s < score_min) {
+				score_min = s;
+				l_min = l_grille;
+				c_min = c_grille;
+			}
+		}
+	}
+	if(score_min >= DISTANCE_MAX_CHAMFER) {
+		return false; // aucun contour près d'aucun cercle
+	}
+	// Descente pixel par pixel (les 8 voisins)
+	bool deplace = true;
+	for (int etape=0; deplace && etape < 4*PAS_GRILLE_CHAMFER; etape++) {
+		deplace = false;
+		int l_centre = l_min, c_centre = c_min;
+		for (int dl=-1; dl <= 1; dl++) {
+			for (int dc=-1; dc <= 1; dc++) {
+				int l_voisin = l_centre + dl, c_voisin = c_centre + dc;
+				if((dl == 0 && dc == 0) || l_voisin < 1 || c_voisin < 1 || l_voisin >= lignes-1 || c_voisin >= colonnes-1) {
+					continue;
+				}
+				double s = score(l_voisin, c_voisin);
+				if(s < score_min) {
+					score_min = s;
+					l_min = l_voisin;
+					c_min = c_voisin;
+					deplace = true;
+				}
+			}
+		}
+	}
+	// Sous-pixel : cercle exact (distances interpolées) sur une grille de 1/SUBDIVISIONS_CHAMFER px
+	// à +/- 1 px du meilleur pixel. Le fond du minimum étant plat (contour épais de quelques pixels),
+	// on prend le milieu des positions à moins de 1% du minimum : sur +/- 0.5 px seulement, ce fond
+	// était coupé par le bord de la grille et son milieu tiré vers le pixel entier.
+	const int n = SUBDIVISIONS_CHAMFER;
+	const double pas = 1.0/SUBDIVISIONS_CHAMFER;
+	double scores[2*SUBDIVISIONS_CHAMFER+1][2*SUBDIVISIONS_CHAMFER+1], score_fin = INFINI_CHAMFER;
+	for (int i=-n; i <= n; i++) {
+		for (int j=-n; j <= n; j++) {
+			scores[i+n][j+n] = scoreSousPixel(l_min + i*pas, c_min + j*pas);
+			score_fin = min(score_fin, scores[i+n][j+n]);
+		}
+	}
+	double somme_l = 0, somme_c = 0;
+	int nb_minimums = 0;
+	for (int i=-n; i <= n; i++) {
+		for (int j=-n; j <= n; j++) {
+			if(scores[i+n][j+n] <= 1.01*score_fin) {
+				somme_l += i*pas;
+				somme_c += j*pas;
+				nb_minimums++;
+			}
+		}
+	}
+	// La dérivée au pixel i étant calculée avec le pixel i-1, le limbe est en i-0.5
+	*l = l_min + somme_l/nb_minimums - 0.5;
+	*c = c_min + somme_c/nb_minimums - 0.5;
+	const MonDouble* centre = distances + (l_min + marge)*colonnes_dist + c_min + marge;
+	int proches = 0;
+	for (int i=0; i < nb_points_cercle; i++) {
+		if(centre[cercle_l[i]*colonnes_dist + cercle_c[i]] <= DISTANCE_PROCHE_CHAMFER) {
+			proches++;
+		}
+	}
+	*ratio_limbe = (double)proches / nb_points_cercle;
+#if DEBUG
+	printf ("Temps chamfer = %4.3f s (distance moyenne %.2f px)\n", (double)(clock() - temps_calcul) /CLOCKS_PER_SEC, score_min);
+#endif
+	return true;
+}
@@ -0,0 +1,50 @@
+/*
+ * chamfer.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Localisation par distance au contour (chamfer) : la transformée en distance
+ *  euclidienne des contours de l'image est calculée une fois par image (en temps
+ *  linéaire), puis un centre candidat est noté par la moyenne des distances lues
+ *  sur les points d'un cercle du diamètre du soleil. Les distances sont plafonnées :
+ *  un morceau du limbe caché (nuage, bord de la coupole) ne coûte que ce plafond.
+ */
+
+#ifndef CHAMFER_H_
+#define CHAMFER_H_
+
+#include "image.h"
+
+#define SEUIL_CONTOUR_CHAMFER	0.3		// entre 0 et 1 (% du max de la dérivée) au dessus duquel un pixel est un contour
+#define DISTANCE_MAX_CHAMFER	10		// en px, plafond des distances au contour
+#define PAS_GRILLE_CHAMFER		4		// en px, pas de la grille des premiers centres essayés
+#define SUBDIVISIONS_CHAMFER	20		// pixel divisé en 20 pour la recherche sous-pixel (pas de 0.05 px)
+#define DISTANCE_PROCHE_CHAMFER	1.5		// en px, un point du cercle plus proche d'un contour est "sur le limbe"
+
+class Chamfer {
+private:
+	int lignes, colonnes;	// Taille des images pour laquelle les espaces de travail sont prêts
+	int marge;				// Les distances sont entourées de "marge" px à DISTANCE_MAX_CHAMFER
+	int lignes_dist, colonnes_dist;
+	MonDouble* distances;	// Distance (plafonnée) de chaque pixel au contour le plus proche
+	double *f, *d, *z;		// Espaces de travail de la transformée en distance (une ligne ou colonne)
+	int *v;
+	// Points du cercle (décalages entiers par rapport au centre) pour le diamètre "diametre_cercle"
+	int *cercle_l, *cercle_c;
+	int nb_points_cercle, diametre_cercle;
+	double *sinus, *cosinus;	// Points du cercle non arrondis (nb_angles_cercle angles)
+	int nb_angles_cercle;
+
+	void preparer(int lignes, int colonnes, int diametre);
+	void liberer();
+	void calculerDistances(Image& obj, double seuil_relatif);
+	void distance1D(int n);
+	double score(int l, int c);
+	double scoreSousPixel(double l, double c);
+public:
+	Chamfer();
+	~Chamfer();
+	bool trouverPosition(Image& obj, int diametre, double *l, double *c, double *ratio_limbe);
+};
+
+#endif /* CHAMFER_H_ */
@@ -0,0 +1,918 @@
+/*
+ * correlateur.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Moteur de corrélation utilisé par Capture à chaque image. Il remplace les appels
+ *  à correlation_rapide_centree (ou correlation_fft_centree) qui, à chaque image,
+ *  recopiaient et normalisaient la référence, puis allouaient l'espace de corrélation
+ *  complet et l'espace centré (plusieurs dizaines de Mo par image).
+ *
+ *  Le Correlateur est construit par Capture::modifierDiametre() ; les espaces de travail
+ *  sont alloués à la première image (ou quand la taille des images change), puis
+ *  réutilisés. L'espace de corrélation renvoyé par correler() appartient au Correlateur :
+ *  il ne faut pas le supprimer, et il est écrasé à la corrélation suivante.
+ *
+ *  NORMALISATION: l'espace de corrélation complet de correlation_rapide a un minimum nul
+ *  (le bord de la dérivée de l'objet est nul), donc sa normalisation sur [0, INTENSITE_MAX]
+ *  revient à diviser par le maximum. On fait ici la même chose sur l'espace centré,
+ *  ce qui garde le même rapport signal/bruit (calculerSignalSurBruit), et le rapport pic/lobes
+ *  (rapportPicLobes) est calculé sur les sommes par bloc d'avant la normalisation. Avec NORMALISATION_ZNCC,
+ *  l'espace contient à la place le score normalisé centré de chaque décalage (normaliserZNCC).
+ */
+
+#include "correlateur.h"
+#include <cmath>
+
+/**
+ * @param reference L'image de référence (laplacien de la forme du soleil)
+ * @param seuil_ref Le seuil minimal de prise en compte des valeurs des pixels de la référence, entre 0 et 1
+ * @param methode La méthode de corrélation utilisée
+ * @param threads Les threads qui se partagent le calcul (NULL pour tout calculer dans
+ * le thread appelant) ; ils ne doivent pas être détruits avant le Correlateur
+ * @param precision Précision des calculs de la méthode directe et de correlerFenetre()
+ * (les méthodes FFT et segments sont toujours calculées en double)
+ * @param normalisation Normalisation de l'espace de corrélation renvoyé par correler() et correlerFenetre()
+ */
+Correlateur::Correlateur(Image& reference, float seuil_ref, MethodeCorrelation methode, ThreadsCalcul* threads,
+		PrecisionCorrelation precision, NormalisationCorrelation normalisation) {
+	this->methode = methode;
+	this->precision = precision;
+	this->normalisation = normalisation;
+	obj_simple = dst_simple = NULL;
+	taille_obj_simple = taille_dst_simple = 0;
+	this->threads = threads;
+	nb_threads = threads ? threads->getNombreThreads() : 1;
+	tache_obj = tache_dst = NULL;
+	tache_l_0 = tache_c_0 = 0;
+	lignes = colonnes = 0;
+	sortie = fenetre = NULL;
+	fenetre_l = fenetre_c = 0;
+	plan_lignes = plan_colonnes = NULL;
+	spectre_ref = spectre_obj = tampon = NULL;
+
+	for (int k=0; k < NIVEAUX_ELIMINATION; k++) {
+		blocs_elimination[k] = NULL;
+		nb_blocs_elimination[k] = 0;
+	}
+	integrale_obj = integrale_carres_obj = NULL;
+	taille_integrale_obj = integrale_lignes = integrale_colonnes = 0;
+	tas = NULL;
+	taille_tas = nb_cellules = 0;
+	dernier_espace = NULL;
+	sommes_lobes = carres_lobes = NULL;
+	taille_lobes = blocs_lobes_colonnes = 0;
+	facteur_lobes = 1;
+
+	ref = reference.referenceSeuillee(seuil_ref);
+	int ref_lignes = ref->getLignes(), ref_colonnes = ref->getColonnes();
+	taillesLobes(max(ref_lignes, ref_colonnes), &demi_lobes, &demi_exclusion);
+	nb_points = 0;
+	for (int l=0; l < ref_lignes; l++) {
+		for (int c=0; c < ref_colonnes; c++) {
+			if(ref->getPix(l,c) > 0) {
+				nb_points++;
+				if(methode == CORRELATION_SEGMENTS) {
+					ref->setPix(l, c, INTENSITE_MAX); // Anneau "plat"
+				}
+			}
+		}
+	}
+	// Moyenne et norme centrée des poids effectivement corrélés (anneau plat pour la méthode segments),
+	// zéros du rectangle compris (NORMALISATION_ZNCC)
+	double somme_ref = 0, somme_carres_ref = 0;
+	for (int l=0; l < ref_lignes; l++) {
+		for (int c=0; c < ref_colonnes; c++) {
+			somme_ref += ref->getPix(l,c);
+			somme_carres_ref += ref->getPix(l,c)*ref->getPix(l,c);
+		}
+	}
+	moyenne_ref = somme_ref / (ref_lignes*ref_colonnes);
+	norme_ref = sqrt(max(0.0, somme_carres_ref - somme_ref*moyenne_ref));
+	// Segments de l'anneau plat, seulement si la méthode est choisie
+	segments = (methode == CORRELATION_SEGMENTS) ? new CorrelateurSegments(*ref) : NULL;
+	// Liste des points gardés (un anneau fin avec SEUIL_CORRELATION = 0.90) : la méthode
+	// directe ne parcourt plus toute la référence ni ne teste le seuil à chaque image
+	points = new PointReference<MonDouble>[max(nb_points, 1)];
+	points_simple = new PointReference<float>[max(nb_points, 1)];
+	for (int l=0, i=0; l < ref_lignes; l++) {
+		for (int c=0; c < ref_colonnes; c++) {
+			if(ref->getPix(l,c) > 0) {
+				points[i].l = points_simple[i].l = l - (ref_lignes-1-ref_lignes/2);
+				points[i].c = points_simple[i].c = c - (ref_colonnes-1-ref_colonnes/2);
+				points[i].poids = ref->getPix(l,c);
+				points_simple[i].poids = ref->getPix(l,c);
+				i++;
+			}
+		}
+	}
+}
+
+Correlateur::~Correlateur() {
+	liberer();
+	if(fenetre) delete fenetre;
+	delete [] points;
+	delete [] points_simple;
+	if(segments) delete segments;
+	if(obj_simple) delete [] obj_simple;
+	if(dst_simple) delete [] dst_simple;
+	for (int k=0; k < NIVEAUX_ELIMINATION; k++) {
+		if(blocs_elimination[k]) delete [] blocs_elimination[k];
+	}
+	if(integrale_obj) delete [] integrale_obj;
+	if(integrale_carres_obj) delete [] integrale_carres_obj;
+	if(tas) delete [] tas;
+	if(sommes_lobes) delete [] sommes_lobes;
+	if(carres_lobes) delete [] carres_lobes;
+	delete ref;
+}
+
+/**
+ * Libère les espaces de travail
+ */
+void Correlateur::liberer() {
+	if(sortie) delete sortie;
+	if(spectre_ref) delete [] spectre_ref;
+	if(spectre_obj) delete [] spectre_obj;
+	if(tampon) delete [] tampon;
+	fft_detruire_plan(plan_lignes);
+	fft_detruire_plan(plan_colonnes);
+	sortie = NULL;
+	dernier_espace = NULL;
+	plan_lignes = plan_colonnes = NULL;
+	spectre_ref = spectre_obj = tampon = NULL;
+	lignes = colonnes = 0;
+}
+
+/**
+ * Alloue les espaces de travail pour des images objet de taille lignes x colonnes ;
+ * ne fait rien si c'est déjà le cas
+ */
+void Correlateur::preparer(int lignes, int colonnes) {
+	if(lignes == this->lignes && colonnes == this->colonnes) {
+		return;
+	}
+	liberer();
+	this->lignes = lignes;
+	this->colonnes = colonnes;
+	sortie = new Image(lignes, colonnes);
+
+	if(methode == CORRELATION_FFT) {
+		// Taille minimale pour que l'espace centré ne soit pas touché par le recouvrement
+		// circulaire : les décalages calculés vont de -(ref-1) à lignes-1, et on en lit
+		// "lignes" à partir de -(ref-1-ref/2)
+		plan_lignes = fft_creer_plan(fft_taille_optimale(lignes + ref->getLignes()/2));
+		plan_colonnes = fft_creer_plan(fft_taille_optimale(max(colonnes + ref->getColonnes()/2, 2)));
+		int P = plan_lignes->n, M = plan_colonnes->n/2+1;
+		spectre_ref = new double[P*2*M];
+		spectre_obj = new double[P*2*M];
+		tampon = new double[nb_threads*2*plan_colonnes->n];
+		fft_2d_reelle(plan_lignes, plan_colonnes, ref->ptr(), ref->getLignes(), ref->getColonnes(),
+				ref->getColonnes(), spectre_ref, tampon);
+	}
+}
+
+/**
+ * Exécute les tâches 0 à nb_taches-1 (avec this comme contexte), en parallèle s'il y a
+ * des threads. Chaque tâche écrit dans sa propre partie du résultat, qui est donc le
+ * même quel que soit le nombre de threads.
+ */
+void Correlateur::executer(TacheCalcul tache, int nb_taches) {
+	if(threads) {
+		threads->executer(tache, this, nb_taches);
+	} else {
+		for (int i=0; i < nb_taches; i++) {
+			tache(this, i, 0);
+		}
+	}
+}
+
+/**
+ * Corrèle l'objet avec la référence
+ * @param obj L'image objet (dérivée de l'image capturée)
+ * @return L'espace de corrélation centré (même espace que correlation_rapide_centree),
+ * qui appartient au Correlateur et sera écrasé à la prochaine corrélation
+ */
+Image* Correlateur::correler(Image& obj) {
+	preparer(obj.getLignes(), obj.getColonnes());
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	preparerLobes(*sortie);
+	if(methode == CORRELATION_FFT) {
+		correlerFFT(obj);
+	} else {
+		correlerDirecte(obj, 0, 0, *sortie);
+	}
+	if(normalisation == NORMALISATION_ZNCC) {
+		normaliserZNCC(obj, 0, 0, *sortie);
+	} else {
+		sortie->reinitialiserMinMax();
+		if(sortie->valeurMax() > 0) { // pas d'image (ciel couvert) : espace laissé tel quel
+			facteur_lobes = INTENSITE_MAX / sortie->valeurMax();
+			sortie->multiplier(facteur_lobes);
+		}
+	}
+#if DEBUG
+	printf ("Temps correlation = %4.2f s\n",  (double)(clock() - temps_calcul) /CLOCKS_PER_SEC);
+#endif
+	return sortie;
+}
+
+/**
+ * Corrèle l'objet avec la référence seulement dans une fenêtre carrée de l'espace centré,
+ * par exemple autour de la dernière position connue du soleil (suivi). La fenêtre est
+ * toujours calculée par la méthode directe : sur quelques milliers de décalages, elle
+ * est bien moins chère qu'une FFT de l'image entière.
+ * @param obj L'image objet (dérivée de l'image capturée)
+ * @param l_centre Centre de la fenêtre dans l'espace centré (donc dans l'objet)
+ * @param c_centre
+ * @param demi_taille La fenêtre va de centre-demi_taille à centre+demi_taille (coupée aux bords de l'objet)
+ * @return La fenêtre de l'espace de corrélation, qui appartient au Correlateur ; son point (0,0)
+ * correspond au point (getFenetreLigne(), getFenetreColonne()) de l'espace centré.
+ * NULL si la fenêtre est en dehors de l'objet.
+ */
+Image* Correlateur::correlerFenetre(Image& obj, int l_centre, int c_centre, int demi_taille) {
+	int l_deb = max(0, l_centre - demi_taille);
+	int c_deb = max(0, c_centre - demi_taille);
+	int l_fin = min(obj.getLignes(), l_centre + demi_taille + 1);
+	int c_fin = min(obj.getColonnes(), c_centre + demi_taille + 1);
+	if(l_fin <= l_deb || c_fin <= c_deb) {
+		return NULL;
+	}
+	if(fenetre == NULL || fenetre->getLignes() != l_fin-l_deb || fenetre->getColonnes() != c_fin-c_deb) {
+		if(fenetre) delete fenetre;
+		fenetre = new Image(l_fin-l_deb, c_fin-c_deb);
+	}
+	fenetre_l = l_deb;
+	fenetre_c = c_deb;
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	preparerLobes(*fenetre);
+	correlerDirecte(obj, l_deb, c_deb, *fenetre);
+	if(normalisation == NORMALISATION_ZNCC) {
+		normaliserZNCC(obj, l_deb, c_deb, *fenetre);
+	} else {
+		fenetre->reinitialiserMinMax();
+		if(fenetre->valeurMax() > 0) {
+			facteur_lobes = INTENSITE_MAX / fenetre->valeurMax();
+			fenetre->multiplier(facteur_lobes);
+		}
+	}
+#if DEBUG
+	printf ("Temps correlation fenetre = %4.3f s\n",  (double)(clock() - temps_calcul) /CLOCKS_PER_SEC);
+#endif
+	return fenetre;
+}
+
+/**
+ * Normalisation ZNCC de dst, qui contient la corrélation (non normalisée) de l'objet avec ref.
+ * Pour le décalage u, avec T les poids de ref sur tout son rectangle (N points, zéros compris)
+ * et I l'objet recouvert (nul en dehors de l'objet, comme pour le calcul de dst) :
+ *   somme (T - moyenne T)(I - moyenne I) = dst(u) - moyenne T x somme I
+ *   ZNCC(u) = (dst(u) - moyenne T x somme I) / (norme_ref x racine(somme I^2 - (somme I)^2 / N))
+ * La somme centrée de T n'est donc jamais calculée (les zéros de ref restent ignorés par
+ * toutes les méthodes), et les sommes de I et I^2 sur le rectangle viennent des images
+ * intégrales de l'objet : O(1) par décalage, un passage sur l'objet et un sur dst en plus.
+ * @param l_0 Coordonnées dans l'objet du point (0,0) de dst
+ * @param c_0
+ */
+void Correlateur::normaliserZNCC(Image& obj, int l_0, int c_0, Image& dst) {
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	calculerIntegraleObjet(obj);
+	tache_obj = &obj;
+	tache_dst = &dst;
+	tache_l_0 = l_0;
+	tache_c_0 = c_0;
+	executer(tacheLignesZNCC, (dst.getLignes() + TUILE_LIGNES-1)/TUILE_LIGNES);
+	dst.reinitialiserMinMax();
+#if DEBUG
+	printf ("Temps normalisation ZNCC = %4.3f s\n",  (double)(clock() - temps_calcul) /CLOCKS_PER_SEC);
+#endif
+}
+
+/**
+ * Tâche de normaliserZNCC : un bloc de TUILE_LIGNES lignes de tache_dst
+ */
+void Correlateur::tacheLignesZNCC(void* correlateur, int indice, int /* num_thread */) {
+	Correlateur* moi = (Correlateur*)correlateur;
+	Image* dst = moi->tache_dst;
+	int dst_lignes = dst->getLignes(), dst_colonnes = dst->getColonnes();
+	int obj_lignes = moi->integrale_lignes, obj_colonnes = moi->integrale_colonnes, largeur = obj_colonnes+1;
+	int h = moi->ref->getLignes(), w = moi->ref->getColonnes();
+	double n = (double)h*w;
+	int l_fin = min((indice+1)*TUILE_LIGNES, dst_lignes);
+	for (int l = indice*TUILE_LIGNES; l < l_fin; l++) {
+		// Rectangle de ref sur l'objet : lignes [l_haut, l_bas[ et colonnes [c_gauche, c_droite[, coupées aux bords
+		int l_ref = moi->tache_l_0 + l - (h-1-h/2);
+		int l_haut = max(0, min(obj_lignes, l_ref)), l_bas = max(0, min(obj_lignes, l_ref + h));
+		const MonDouble *haut = moi->integrale_obj + l_haut*largeur, *bas = moi->integrale_obj + l_bas*largeur;
+		const MonDouble *haut_carres = moi->integrale_carres_obj + l_haut*largeur;
+		const MonDouble *bas_carres = moi->integrale_carres_obj + l_bas*largeur;
+		MonDouble *dst_pt = dst->ptr() + l*dst_colonnes;
+		for (int c=0; c < dst_colonnes; c++) {
+			int c_ref = moi->tache_c_0 + c - (w-1-w/2);
+			int c_gauche = max(0, min(obj_colonnes, c_ref)), c_droite = max(0, min(obj_colonnes, c_ref + w));
+			double somme = bas[c_droite] - bas[c_gauche] - haut[c_droite] + haut[c_gauche];
+			double somme_carres = bas_carres[c_droite] - bas_carres[c_gauche] - haut_carres[c_droite] + haut_carres[c_gauche];
+			double variance = somme_carres - somme*somme/n;
+			// Objet constant sous ref (aux erreurs d'arrondi près) : pas de score
+			dst_pt[c] = (variance > 1e-9*somme_carres && moi->norme_ref > 0)
+					? (dst_pt[c] - moi->moyenne_ref*somme) / (moi->norme_ref*sqrt(variance)) : 0;
+		}
+	}
+	moi->sommerLobes(*dst, indice*TUILE_LIGNES, l_fin, 0, dst_colonnes);
+}
+
+/**
+ * Prépare les sommes par bloc du rapport pic/lobes pour l'espace dst, que les tâches vont
+ * calculer (sommerLobes) : dst devient le dernier espace calculé
+ */
+void Correlateur::preparerLobes(Image& dst) {
+	blocs_lobes_colonnes = (dst.getColonnes() + BLOC_LOBES-1)/BLOC_LOBES;
+	int taille = ((dst.getLignes() + BLOC_LOBES-1)/BLOC_LOBES) * blocs_lobes_colonnes;
+	if(taille > taille_lobes) {
+		if(sommes_lobes) delete [] sommes_lobes;
+		if(carres_lobes) delete [] carres_lobes;
+		sommes_lobes = new MonDouble[taille];
+		carres_lobes = new MonDouble[taille];
+		taille_lobes = taille;
+	}
+	dernier_espace = &dst;
+	facteur_lobes = 1;
+}
+
+/**
+ * Sommes des valeurs et de leurs carrés des blocs de BLOC_LOBES px de la partie [l_deb, l_fin[ x
+ * [c_deb, c_fin[ de dst, l_deb et c_deb étant des débuts de bloc. Appelée par chaque tâche sur la
+ * partie de dst qu'elle vient d'écrire (tuile, bloc de lignes), encore dans le cache : le rapport
+ * pic/lobes ne relit ensuite que quelques dizaines de blocs et le carré du pic. Les parties écrites
+ * par deux tâches n'ont pas de bloc commun. En ZNCC, seules les sommes de l'espace normalisé
+ * (tacheLignesZNCC) sont gardées.
+ */
+void Correlateur::sommerLobes(Image& dst, int l_deb, int l_fin, int c_deb, int c_fin) {
+	int dst_colonnes = dst.getColonnes();
+	for (int l_bloc = l_deb; l_bloc < l_fin; l_bloc += BLOC_LOBES) {
+		for (int c_bloc = c_deb; c_bloc < c_fin; c_bloc += BLOC_LOBES) {
+			int l_fin_bloc = min(l_bloc + BLOC_LOBES, l_fin), c_fin_bloc = min(c_bloc + BLOC_LOBES, c_fin);
+			MonDouble somme = 0, somme_carres = 0;
+			for (int l = l_bloc; l < l_fin_bloc; l++) {
+				const MonDouble *dst_pt = dst.ptr() + l*dst_colonnes;
+				for (int c = c_bloc; c < c_fin_bloc; c++) {
+					somme += dst_pt[c];
+					somme_carres += dst_pt[c]*dst_pt[c];
+				}
+			}
+			int i = (l_bloc/BLOC_LOBES)*blocs_lobes_colonnes + c_bloc/BLOC_LOBES;
+			sommes_lobes[i] = somme;
+			carres_lobes[i] = somme_carres;
+		}
+	}
+}
+
+/**
+ * Demi-côtés des carrés du rapport pic/lobes (Image::rapportPicLobes), proportionnels à
+ * la taille de la référence (un peu plus grande que le soleil)
+ * @param taille_ref En px, plus grand côté de la référence
+ * @param demi_lobes Demi-côté du carré des lobes
+ * @param demi_exclusion Demi-côté du carré du pic, exclu des lobes
+ */
+void Correlateur::taillesLobes(int taille_ref, int *demi_lobes, int *demi_exclusion) {
+	*demi_exclusion = max((int)(taille_ref * FRACTION_EXCLUSION_PIC), EXCLUSION_PIC_MIN);
+	*demi_lobes = max((int)(taille_ref * FRACTION_LOBES_PIC), 2*(*demi_exclusion));
+}
+
+/**
+ * Convertit le centre d'un disque dans l'objet (ajustement du limbe, Chamfer) en position du
+ * pic de corrélation de ce disque : le disque de la référence est centré sur le point
+ * (lignes/2, colonnes/2) de la référence (tracerFormeSoleil), mais le décalage (l,c) de
+ * l'espace centré met le point (lignes-1-lignes/2, colonnes-1-colonnes/2) sur le point (l,c)
+ * de l'objet. Le pic est donc 1 px avant le centre sur un côté pair de la référence.
+ * Toutes les méthodes de localisation donnent ainsi la même position pour la même image.
+ * @param l Centre du disque dans l'objet, remplacé par la position du pic
+ * @param c
+ */
+void Correlateur::centreVersPic(double *l, double *c) {
+	int ref_lignes = ref->getLignes(), ref_colonnes = ref->getColonnes();
+	*l += (ref_lignes-1-ref_lignes/2) - ref_lignes/2;
+	*c += (ref_colonnes-1-ref_colonnes/2) - ref_colonnes/2;
+}
+
+/**
+ * Rapport pic/lobes (comme Image::rapportPicLobes) du dernier espace calculé (correler() ou
+ * correlerFenetre()), avec les carrés proportionnels au diamètre de ce Correlateur. Les lobes
+ * sont les blocs de BLOC_LOBES px qui recouvrent le carré de +/- demi_lobes px autour du pic :
+ * leurs sommes viennent de sommerLobes(), et seul le carré du pic, exclu, est relu.
+ * Pour correlerFenetre(), la fenêtre doit dépasser la zone de recherche de getDemiLobes()
+ * + BLOC_LOBES px pour que les lobes ne soient pas coupés par son bord.
+ * @param l Position du pic dans l'espace
+ * @param c
+ * @return Le rapport, ou 0 si les lobes sont vides ou constants (ou si rien n'a été calculé)
+ */
+double Correlateur::rapportPicLobes(int l, int c) {
+	if(dernier_espace == NULL || l < 0 || l >= dernier_espace->getLignes() || c < 0 || c >= dernier_espace->getColonnes()) {
+		return 0;
+	}
+	int espace_lignes = dernier_espace->getLignes(), espace_colonnes = dernier_espace->getColonnes();
+	int l_deb = max(0, l - demi_lobes)/BLOC_LOBES, l_fin = min(espace_lignes-1, l + demi_lobes)/BLOC_LOBES + 1;
+	int c_deb = max(0, c - demi_lobes)/BLOC_LOBES, c_fin = min(espace_colonnes-1, c + demi_lobes)/BLOC_LOBES + 1;
+	double somme = 0, somme_carres = 0;
+	int n = 0;
+	for (int l_bloc = l_deb; l_bloc < l_fin; l_bloc++) {
+		int hauteur = min(BLOC_LOBES, espace_lignes - l_bloc*BLOC_LOBES);
+		for (int c_bloc = c_deb; c_bloc < c_fin; c_bloc++) {
+			somme += sommes_lobes[l_bloc*blocs_lobes_colonnes + c_bloc];
+			somme_carres += carres_lobes[l_bloc*blocs_lobes_colonnes + c_bloc];
+			n += hauteur * min(BLOC_LOBES, espace_colonnes - c_bloc*BLOC_LOBES);
+		}
+	}
+	// Carré du pic, dans l'échelle des sommes (avant normalisation)
+	for (int i = max(0, l - demi_exclusion); i < min(espace_lignes, l + demi_exclusion + 1); i++) {
+		const MonDouble *ligne = dernier_espace->ptr() + i*espace_colonnes;
+		for (int j = max(0, c - demi_exclusion); j < min(espace_colonnes, c + demi_exclusion + 1); j++) {
+			somme -= ligne[j]/facteur_lobes;
+			somme_carres -= ligne[j]*ligne[j]/(facteur_lobes*facteur_lobes);
+			n--;
+		}
+	}
+	if(n < 2) {
+		return 0;
+	}
+	double moyenne = somme/n, variance = somme_carres/n - moyenne*moyenne;
+	if(variance <= 0) {
+		return 0;
+	}
+	return (dernier_espace->getPix(l,c)/facteur_lobes - moyenne) / sqrt(variance);
+}
+
+/**
+ * Position du maximum de l'espace de corrélation centré, sans calculer tout l'espace
+ * (élimination successive, ou "branch and bound"). Les poids de la référence et l'objet
+ * étant positifs, le score de tous les décalages d'une cellule est majoré bloc par bloc de
+ * la référence à partir des sommes de l'objet (et de son carré) sous le bloc agrandi de la
+ * taille de la cellule, chaque somme coûtant 4 lectures d'une image intégrale. On examine d'abord la cellule de plus grande borne ; une cellule dont la borne
+ * ne dépasse pas le meilleur score exact déjà calculé est éliminée avec tous ses décalages,
+ * les autres sont divisées en 4, jusqu'aux décalages seuls dont on calcule le score exact.
+ * Le résultat est donc exactement le maximum de correler(), à une fraction du coût quand
+ * la référence est grande et le limbe bien contrasté (seules les cellules proches du pic
+ * sont divisées jusqu'au bout). Sur un limbe faible devant le bruit de la dérivée (nuages),
+ * les bornes n'éliminent presque rien : on abandonne après TRAVAIL_MAX_ELIMINATION fois le
+ * travail de la corrélation complète qui prendra alors le relais (travailCorrelation), pour
+ * ne pas perdre plus de temps que ce qu'on espérait gagner.
+ * @param obj L'image objet (dérivée de l'image capturée)
+ * @param l Position du maximum dans l'espace centré (au pixel près)
+ * @param c
+ * @return false si la recherche a été abandonnée
+ */
+bool Correlateur::chercherMaximum(Image& obj, int *l, int *c) {
+#if DEBUG
+	double temps_calcul = (double)(clock());
+	int nb_bornes = 0, nb_scores = 0;
+#endif
+	if(blocs_elimination[1] == NULL) {
+		preparerElimination();
+	}
+	calculerIntegraleObjet(obj);
+	int obj_lignes = obj.getLignes(), obj_colonnes = obj.getColonnes();
+	const int niveau_max = NIVEAUX_ELIMINATION-1;
+	// Travail (en unités de COUT_UNITE_ELIMINATION multiplications-additions) au delà duquel on abandonne
+	double travail = 0, travail_max = TRAVAIL_MAX_ELIMINATION * travailCorrelation(obj_lignes, obj_colonnes) / COUT_UNITE_ELIMINATION;
+	nb_cellules = 0;
+	for (int l_cellule=0; l_cellule < obj_lignes; l_cellule += TAILLE_CELLULE_ELIMINATION) {
+		for (int c_cellule=0; c_cellule < obj_colonnes; c_cellule += TAILLE_CELLULE_ELIMINATION) {
+			ajouterCellule(l_cellule, c_cellule, niveau_max, borneCellule(l_cellule, c_cellule, niveau_max));
+			travail += nb_blocs_elimination[niveau_max];
+		}
+	}
+	MonDouble meilleur = -1;
+	*l = *c = 0;
+	while(nb_cellules > 0 && travail <= travail_max) {
+		CelluleDecalages cellule = retirerCellule();
+		// Marge pour les erreurs d'arrondi des sommes des images intégrales
+		if(cellule.borne * (1 + 1e-9) <= meilleur) {
+			nb_cellules = 0; // les bornes des cellules restantes sont plus petites
+			break;
+		}
+		int demi = 1 << (cellule.niveau-1);
+		for (int i=0; i < 4; i++) {
+			int l_fille = cellule.l + (i/2)*demi, c_fille = cellule.c + (i%2)*demi;
+			if(l_fille >= obj_lignes || c_fille >= obj_colonnes) {
+				continue;
+			}
+			if(cellule.niveau == 1) {
+				MonDouble score = scoreDecalage(obj.ptr(), l_fille, c_fille);
+				travail += nb_points;
+#if DEBUG
+				nb_scores++;
+#endif
+				if(score > meilleur) {
+					meilleur = score;
+					*l = l_fille;
+					*c = c_fille;
+				}
+			} else {
+				double borne = borneCellule(l_fille, c_fille, cellule.niveau-1);
+				travail += nb_blocs_elimination[cellule.niveau-1];
+#if DEBUG
+				nb_bornes++;
+#endif
+				if(borne * (1 + 1e-9) > meilleur) {
+					ajouterCellule(l_fille, c_fille, cellule.niveau-1, borne);
+				}
+			}
+		}
+	}
+#if DEBUG
+	printf ("Elimination successive : %d scores exacts sur %d decalages, %d bornes, en %4.3f s%s\n",
+			nb_scores, obj_lignes*obj_colonnes, nb_bornes, (double)(clock() - temps_calcul) /CLOCKS_PER_SEC,
+			(nb_cellules > 0) ? " (abandon)" : "");
+#endif
+	return nb_cellules == 0 && meilleur > 0;
+}
+
+/**
+ * Travail estimé de correler() sur un objet de lignes x colonnes, en multiplications-additions
+ * de la méthode directe, ramené au temps écoulé : divisé par le nombre de threads (chercherMaximum
+ * n'utilise que le thread appelant) et par 2 pour la méthode directe en float
+ */
+double Correlateur::travailCorrelation(int lignes, int colonnes) {
+	double travail;
+	if(methode == CORRELATION_FFT) {
+		double P = fft_taille_optimale(lignes + ref->getLignes()/2);
+		double Q = fft_taille_optimale(max(colonnes + ref->getColonnes()/2, 2));
+		travail = COUT_FFT * P * Q * log2(P * Q);
+	} else if(methode == CORRELATION_SEGMENTS) {
+		travail = COUT_SEGMENT * lignes * colonnes * segments->getNombreSegments();
+	} else {
+		travail = (double)lignes * colonnes * nb_points;
+		if(precision == PRECISION_SIMPLE) {
+			travail /= 2;
+		}
+	}
+	return travail / nb_threads;
+}
+
+/**
+ * Blocs de la référence pour chaque niveau de cellules : au niveau k (cellules de 2^k
+ * décalages de côté), blocs de max(2^k, BLOC_ELIMINATION_MIN) px ; les blocs vides ne
+ * sont pas gardés
+ */
+void Correlateur::preparerElimination() {
+	int ref_lignes = ref->getLignes(), ref_colonnes = ref->getColonnes();
+	for (int k=1; k < NIVEAUX_ELIMINATION; k++) {
+		int taille = max(1 << k, BLOC_ELIMINATION_MIN);
+		int blocs_lignes = (ref_lignes + taille-1)/taille, blocs_colonnes = (ref_colonnes + taille-1)/taille;
+		MonDouble* poids_max = new MonDouble[blocs_lignes*blocs_colonnes];
+		MonDouble* carres = new MonDouble[blocs_lignes*blocs_colonnes];
+		for (int i=0; i < blocs_lignes*blocs_colonnes; i++) {
+			poids_max[i] = carres[i] = 0;
+		}
+		for (int l=0; l < ref_lignes; l++) {
+			for (int c=0; c < ref_colonnes; c++) {
+				int i = (l/taille)*blocs_colonnes + c/taille;
+				poids_max[i] = max(poids_max[i], ref->getPix(l,c));
+				carres[i] += ref->getPix(l,c)*ref->getPix(l,c);
+			}
+		}
+		blocs_elimination[k] = new BlocReference[blocs_lignes*blocs_colonnes];
+		nb_blocs_elimination[k] = 0;
+		for (int i=0; i < blocs_lignes*blocs_colonnes; i++) {
+			if(poids_max[i] > 0) {
+				BlocReference* bloc = blocs_elimination[k] + nb_blocs_elimination[k]++;
+				bloc->l = (i/blocs_colonnes)*taille - (ref_lignes-1-ref_lignes/2);
+				bloc->c = (i%blocs_colonnes)*taille - (ref_colonnes-1-ref_colonnes/2);
+				bloc->poids_max = poids_max[i];
+				bloc->norme = sqrt(carres[i]);
+			}
+		}
+		delete [] poids_max;
+		delete [] carres;
+	}
+}
+
+/**
+ * Images intégrales de l'objet et de son carré : l'élément (l,c) est la somme des pixels
+ * (ou de leurs carrés) de l'objet d'indices inférieurs à l et à c
+ */
+void Correlateur::calculerIntegraleObjet(Image& obj) {
+	int obj_lignes = obj.getLignes(), obj_colonnes = obj.getColonnes();
+	int largeur = obj_colonnes+1;
+	if((obj_lignes+1)*largeur > taille_integrale_obj) {
+		if(integrale_obj) delete [] integrale_obj;
+		if(integrale_carres_obj) delete [] integrale_carres_obj;
+		integrale_obj = new MonDouble[(obj_lignes+1)*largeur];
+		integrale_carres_obj = new MonDouble[(obj_lignes+1)*largeur];
+		taille_integrale_obj = (obj_lignes+1)*largeur;
+	}
+	integrale_lignes = obj_lignes;
+	integrale_colonnes = obj_colonnes;
+	for (int c=0; c < largeur; c++) {
+		integrale_obj[c] = integrale_carres_obj[c] = 0;
+	}
+	for (int l=0; l < obj_lignes; l++) {
+		const MonDouble *obj_pt = obj.ptr() + l*obj_colonnes;
+		MonDouble *dessus = integrale_obj + l*largeur, *ligne = dessus + largeur;
+		MonDouble *dessus_carres = integrale_carres_obj + l*largeur, *ligne_carres = dessus_carres + largeur;
+		MonDouble somme = 0, somme_carres = 0;
+		ligne[0] = ligne_carres[0] = 0;
+		for (int c=0; c < obj_colonnes; c++) {
+			somme += obj_pt[c];
+			somme_carres += obj_pt[c]*obj_pt[c];
+			ligne[c+1] = dessus[c+1] + somme;
+			ligne_carres[c+1] = dessus_carres[c+1] + somme_carres;
+		}
+	}
+}
+
+/**
+ * Majorant du score des décalages de la cellule [l, l+2^niveau[ x [c, c+2^niveau[ :
+ * les points d'un bloc de la référence, pour tous ces décalages, tombent dans le bloc
+ * agrandi de 2^niveau-1 px vers le bas et la droite. La contribution du bloc est majorée
+ * par (poids max) x (somme de l'objet) et par (norme des poids) x (norme de l'objet)
+ * (Cauchy-Schwarz), bien plus petite sur le bruit de fond de la dérivée qui couvre tout
+ * le bloc alors que l'anneau n'en occupe qu'une ligne. Les sommes sont coupées aux bords
+ * de l'objet (l'objet est nul en dehors, comme pour la méthode directe).
+ */
+double Correlateur::borneCellule(int l, int c, int niveau) {
+	int taille = max(1 << niveau, BLOC_ELIMINATION_MIN) + (1 << niveau) - 1;
+	int largeur = integrale_colonnes+1;
+	const BlocReference* blocs = blocs_elimination[niveau];
+	double borne = 0;
+	for (int i=0; i < nb_blocs_elimination[niveau]; i++) {
+		int l_deb = max(0, min(integrale_lignes, l + blocs[i].l));
+		int l_fin = max(0, min(integrale_lignes, l + blocs[i].l + taille));
+		int c_deb = max(0, min(integrale_colonnes, c + blocs[i].c));
+		int c_fin = max(0, min(integrale_colonnes, c + blocs[i].c + taille));
+		const MonDouble *haut = integrale_obj + l_deb*largeur, *bas = integrale_obj + l_fin*largeur;
+		double somme = bas[c_fin] - bas[c_deb] - haut[c_fin] + haut[c_deb];
+		haut = integrale_carres_obj + l_deb*largeur;
+		bas = integrale_carres_obj + l_fin*largeur;
+		double somme_carres = max(0.0, bas[c_fin] - bas[c_deb] - haut[c_fin] + haut[c_deb]);
+		borne += min(blocs[i].poids_max * somme, blocs[i].norme * sqrt(somme_carres));
+	}
+	return borne;
+}
+
+/**
+ * Score exact d'un décalage (un point de l'espace centré), comme la méthode directe
+ */
+double Correlateur::scoreDecalage(const MonDouble* obj, int l, int c) {
+	int obj_lignes = integrale_lignes, obj_colonnes = integrale_colonnes;
+	double score = 0;
+	for (int i=0; i < nb_points; i++) {
+		int l_obj = l + points[i].l, c_obj = c + points[i].c;
+		if(l_obj >= 0 && l_obj < obj_lignes && c_obj >= 0 && c_obj < obj_colonnes) {
+			score += points[i].poids * obj[l_obj*obj_colonnes + c_obj];
+		}
+	}
+	return score;
+}
+
+/**
+ * Ajoute une cellule au tas (agrandi si besoin)
+ */
+void Correlateur::ajouterCellule(int l, int c, int niveau, double borne) {
+	if(nb_cellules == taille_tas) {
+		taille_tas = max(2*taille_tas, 1024);
+		CelluleDecalages* nouveau = new CelluleDecalages[taille_tas];
+		for (int i=0; i < nb_cellules; i++) {
+			nouveau[i] = tas[i];
+		}
+		if(tas) delete [] tas;
+		tas = nouveau;
+	}
+	// Remontée vers la racine tant que le parent a une borne plus petite
+	int i = nb_cellules++;
+	while(i > 0 && tas[(i-1)/2].borne < borne) {
+		tas[i] = tas[(i-1)/2];
+		i = (i-1)/2;
+	}
+	tas[i].l = l;
+	tas[i].c = c;
+	tas[i].niveau = niveau;
+	tas[i].borne = borne;
+}
+
+/**
+ * Retire la cellule de plus grande borne du tas (qui ne doit pas être vide)
+ */
+CelluleDecalages Correlateur::retirerCellule() {
+	CelluleDecalages racine = tas[0];
+	CelluleDecalages derniere = tas[--nb_cellules];
+	int i = 0;
+	while(2*i+1 < nb_cellules) {
+		int fille = 2*i+1;
+		if(fille+1 < nb_cellules && tas[fille+1].borne > tas[fille].borne) {
+			fille++;
+		}
+		if(tas[fille].borne <= derniere.borne) {
+			break;
+		}
+		tas[i] = tas[fille];
+		i = fille;
+	}
+	tas[i] = derniere;
+	return racine;
+}
+
+/**
+ * Corrélation spatiale calculée uniquement pour les décalages gardés : le point (l,c)
+ * de dst est le décalage où le centre de la référence est sur le point (l_0+l, c_0+c)
+ * de l'objet. Contrairement à correlation_rapide_centree, on ne calcule pas l'espace
+ * complet (décalages où la référence ne recouvre l'objet qu'en partie) pour ensuite
+ * en recopier le centre : chaque produit est directement ajouté dans dst.
+ * Seuls les points de la référence au dessus du seuil (liste "points") sont parcourus.
+ *
+ * dst est découpé en tuiles (TUILE_LIGNES x TUILE_COLONNES) : toutes les contributions
+ * d'une tuile sont accumulées avant de passer à la suivante. En parcourant plutôt dst
+ * en entier pour chaque point de la référence, on relisait et réécrivait dst en mémoire
+ * (points x taille de dst x 16 octets) ; ici dst n'est écrit qu'une fois, et seul l'objet
+ * est lu depuis le cache L2 (voir l'essai "bande" de banc_essai).
+ * @param obj L'image objet
+ * @param l_0 Coordonnées dans l'objet du point (0,0) de dst
+ * @param c_0
+ * @param dst L'espace de corrélation (une partie de l'espace centré)
+ */
+void Correlateur::correlerDirecte(Image& obj, int l_0, int c_0, Image& dst) {
+	int dst_lignes = dst.getLignes(), dst_colonnes = dst.getColonnes();
+	dst.init(0);
+	if(precision == PRECISION_SIMPLE && methode != CORRELATION_SEGMENTS) {
+		int taille_obj = obj.getLignes()*obj.getColonnes();
+		if(taille_obj > taille_obj_simple) {
+			if(obj_simple) delete [] obj_simple;
+			obj_simple = new float[taille_obj];
+			taille_obj_simple = taille_obj;
+		}
+		if(dst_lignes*dst_colonnes > taille_dst_simple) {
+			if(dst_simple) delete [] dst_simple;
+			dst_simple = new float[dst_lignes*dst_colonnes];
+			taille_dst_simple = dst_lignes*dst_colonnes;
+		}
+		// Seule la partie de l'objet lue par les tuiles est convertie : dst plus le bord de la
+		// référence (toute l'image pour correler(), quelques milliers de pixels pour le suivi)
+		int ref_lignes = ref->getLignes(), ref_colonnes = ref->getColonnes();
+		int obj_colonnes = obj.getColonnes();
+		int l_deb = max(0, l_0 - (ref_lignes-1-ref_lignes/2));
+		int l_fin = min(obj.getLignes(), l_0 + dst_lignes + ref_lignes/2);
+		int c_deb = max(0, c_0 - (ref_colonnes-1-ref_colonnes/2));
+		int c_fin = min(obj_colonnes, c_0 + dst_colonnes + ref_colonnes/2);
+		for (int l = l_deb; l < l_fin; l++) {
+			const MonDouble* obj_pt = obj.ptr() + l*obj_colonnes;
+			float* simple_pt = obj_simple + l*obj_colonnes;
+			for (int c = c_deb; c < c_fin; c++) {
+				simple_pt[c] = obj_pt[c];
+			}
+		}
+	}
+	if(segments) {
+		segments->preparerObjet(obj);
+	}
+	tache_obj = &obj;
+	tache_dst = &dst;
+	tache_l_0 = l_0;
+	tache_c_0 = c_0;
+	int tuiles_lignes = (dst_lignes + TUILE_LIGNES-1)/TUILE_LIGNES;
+	int tuiles_colonnes = (dst_colonnes + TUILE_COLONNES-1)/TUILE_COLONNES;
+	executer(tacheTuile, tuiles_lignes*tuiles_colonnes);
+}
+
+/**
+ * Tâche de correlerDirecte : une tuile de tache_dst
+ */
+void Correlateur::tacheTuile(void* correlateur, int indice, int /* num_thread */) {
+	Correlateur* moi = (Correlateur*)correlateur;
+	int dst_lignes = moi->tache_dst->getLignes(), dst_colonnes = moi->tache_dst->getColonnes();
+	int tuiles_colonnes = (dst_colonnes + TUILE_COLONNES-1)/TUILE_COLONNES;
+	int l_tuile = (indice / tuiles_colonnes) * TUILE_LIGNES;
+	int c_tuile = (indice % tuiles_colonnes) * TUILE_COLONNES;
+	int l_fin_tuile = min(l_tuile + TUILE_LIGNES, dst_lignes), c_fin_tuile = min(c_tuile + TUILE_COLONNES, dst_colonnes);
+	moi->correlerTuile(*moi->tache_obj, moi->tache_l_0, moi->tache_c_0, *moi->tache_dst, l_tuile, c_tuile,
+			l_fin_tuile, c_fin_tuile);
+	if(moi->normalisation != NORMALISATION_ZNCC) {
+		moi->sommerLobes(*moi->tache_dst, l_tuile, l_fin_tuile, c_tuile, c_fin_tuile);
+	}
+}
+
+/**
+ * Noyau de la méthode directe, en MonDouble ou en float : ajoute à la tuile
+ * [l_tuile, l_fin_tuile[ x [c_tuile, c_fin_tuile[ de dst les contributions de tous les points
+ */
+template<typename T>
+static void accumulerTuile(const PointReference<T>* points, int nb_points,
+		const T* obj, int obj_lignes, int obj_colonnes, int l_0, int c_0,
+		T* dst, int dst_colonnes, int l_tuile, int c_tuile, int l_fin_tuile, int c_fin_tuile) {
+	for (int i=0; i < nb_points; i++) {
+		const T poids = points[i].poids;
+		// Décalage entre le point de dst et le point de l'objet multiplié par le poids
+		int l_decal = l_0 + points[i].l;
+		int c_decal = c_0 + points[i].c;
+		int l_deb = max(l_tuile, -l_decal);
+		int c_deb = max(c_tuile, -c_decal);
+		int l_fin = min(l_fin_tuile, obj_lignes - l_decal);
+		int c_fin = min(c_fin_tuile, obj_colonnes - c_decal);
+
+		for (int l = l_deb; l < l_fin; l++) {
+			// Boucle sans dépendance entre itérations : vectorisée par le compilateur
+			T* __restrict dst_pt = dst + l*dst_colonnes;
+			const T* __restrict obj_pt = obj + (l+l_decal)*obj_colonnes + c_decal;
+			for (int c = c_deb; c < c_fin; c++) {
+				dst_pt[c] += poids * obj_pt[c];
+			}
+		}
+	}
+}
+
+/**
+ * Calcule la tuile [l_tuile, l_fin_tuile[ x [c_tuile, c_fin_tuile[ de dst (voir correlerDirecte)
+ */
+void Correlateur::correlerTuile(Image& obj, int l_0, int c_0, Image& dst,
+		int l_tuile, int c_tuile, int l_fin_tuile, int c_fin_tuile) {
+	int dst_colonnes = dst.getColonnes();
+	if(segments) {
+		segments->correlerTuile(l_0, c_0, dst, l_tuile, c_tuile, l_fin_tuile, c_fin_tuile);
+	} else if(precision == PRECISION_SIMPLE) {
+		for (int l = l_tuile; l < l_fin_tuile; l++) {
+			for (int c = c_tuile; c < c_fin_tuile; c++) {
+				dst_simple[l*dst_colonnes + c] = 0;
+			}
+		}
+		accumulerTuile<float>(points_simple, nb_points, obj_simple, obj.getLignes(), obj.getColonnes(), l_0, c_0,
+				dst_simple, dst_colonnes, l_tuile, c_tuile, l_fin_tuile, c_fin_tuile);
+		for (int l = l_tuile; l < l_fin_tuile; l++) {
+			for (int c = c_tuile; c < c_fin_tuile; c++) {
+				dst.setPix(l, c, dst_simple[l*dst_colonnes + c]);
+			}
+		}
+	} else {
+		accumulerTuile<MonDouble>(points, nb_points, obj.ptr(), obj.getLignes(), obj.getColonnes(), l_0, c_0,
+				dst.ptr(), dst_colonnes, l_tuile, c_tuile, l_fin_tuile, c_fin_tuile);
+	}
+}
+
+/**
+ * Corrélation dans l'espace des fréquences avec le spectre de la référence gardé en mémoire ;
+ * la transformée inverse écrit directement l'espace centré dans la sortie
+ * (voir correlation_fft). Chaque étape est découpée en blocs de lignes ou de colonnes
+ * indépendants (tâches).
+ */
+void Correlateur::correlerFFT(Image& obj) {
+	int P = plan_lignes->n, M = plan_colonnes->n/2+1;
+	tache_obj = &obj;
+	tache_dst = sortie;
+	executer(tacheLignesFFT, (P + BLOC_LIGNES_FFT-1)/BLOC_LIGNES_FFT);
+	executer(tacheColonnesFFT, (M + BLOC_COLONNES_FFT-1)/BLOC_COLONNES_FFT);
+	executer(tacheLignesFFTInverse, (lignes + BLOC_LIGNES_FFT-1)/BLOC_LIGNES_FFT);
+}
+
+/**
+ * Tâche de correlerFFT : FFT d'un bloc de lignes de l'objet
+ */
+void Correlateur::tacheLignesFFT(void* correlateur, int indice, int num_thread) {
+	Correlateur* moi = (Correlateur*)correlateur;
+	int P = moi->plan_lignes->n, Q = moi->plan_colonnes->n;
+	fft_2d_reelle_lignes(moi->plan_lignes, moi->plan_colonnes, moi->tache_obj->ptr(),
+			moi->lignes, moi->colonnes, moi->colonnes, moi->spectre_obj, moi->tampon + num_thread*2*Q,
+			indice*BLOC_LIGNES_FFT, min((indice+1)*BLOC_LIGNES_FFT, P));
+}
+
+/**
+ * Tâche de correlerFFT : sur un bloc de colonnes du spectre, FFT des colonnes,
+ * produit TF(obj) x conj(TF(ref)) puis FFT inverse des colonnes
+ */
+void Correlateur::tacheColonnesFFT(void* correlateur, int indice, int /* num_thread */) {
+	Correlateur* moi = (Correlateur*)correlateur;
+	int P = moi->plan_lignes->n, M = moi->plan_colonnes->n/2+1;
+	int c_deb = indice*BLOC_COLONNES_FFT, c_fin = min(c_deb + BLOC_COLONNES_FFT, M);
+	fft_colonnes_partie(moi->plan_lignes, moi->spectre_obj, M, c_deb, c_fin, FFT_DIRECTE);
+	for (int l=0; l < P; l++) {
+		double *obj_pt = moi->spectre_obj + 2*l*M;
+		const double *ref_pt = moi->spectre_ref + 2*l*M;
+		for (int k=c_deb; k < c_fin; k++) {
+			double o_re = obj_pt[2*k], o_im = obj_pt[2*k+1];
+			double r_re = ref_pt[2*k], r_im = ref_pt[2*k+1];
+			obj_pt[2*k] = o_re*r_re + o_im*r_im;
+			obj_pt[2*k+1] = o_im*r_re - o_re*r_im;
+		}
+	}
+	fft_colonnes_partie(moi->plan_lignes, moi->spectre_obj, M, c_deb, c_fin, FFT_INVERSE);
+}
+
+/**
+ * Tâche de correlerFFT : FFT inverse d'un bloc de lignes de la sortie. Le point (l,c)
+ * de la sortie correspond au décalage (l-(ref-1-ref/2), c-(...)) entre ref(0,0) et obj(0,0)
+ */
+void Correlateur::tacheLignesFFTInverse(void* correlateur, int indice, int num_thread) {
+	Correlateur* moi = (Correlateur*)correlateur;
+	int Q = moi->plan_colonnes->n;
+	int ref_lignes = moi->ref->getLignes(), ref_colonnes = moi->ref->getColonnes();
+	int l_deb = indice*BLOC_LIGNES_FFT, l_fin = min((indice+1)*BLOC_LIGNES_FFT, moi->lignes);
+	fft_2d_reelle_inverse_lignes(moi->plan_lignes, moi->plan_colonnes, moi->spectre_obj, moi->sortie->ptr(),
+			-(ref_lignes-1-ref_lignes/2), moi->lignes, -(ref_colonnes-1-ref_colonnes/2), moi->colonnes, moi->colonnes,
+			moi->tampon + num_thread*2*Q, l_deb, l_fin);
+	if(moi->normalisation != NORMALISATION_ZNCC) {
+		moi->sommerLobes(*moi->sortie, l_deb, l_fin, 0, moi->colonnes);
+	}
+}
@@ -0,0 +1,190 @@
+/*
+ * correlateur.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Moteur de corrélation persistant : la référence (seuillée, et son spectre pour
+ *  la méthode FFT) et tous les espaces de travail sont gardés d'une image à l'autre.
+ *  Il n'y a donc aucune allocation à chaque image tant que le diamètre et la taille
+ *  des images capturées ne changent pas.
+ */
+
+#ifndef CORRELATEUR_H_
+#define CORRELATEUR_H_
+
+#include "image.h"
+#include "threads_calcul.h"
+#include "correlateur_segments.h"
+
+// Taille des tuiles de l'espace de corrélation pour la méthode directe : une tuile
+// (TUILE_LIGNES x TUILE_COLONNES MonDouble, 16 ko, ou 8 ko en float) reste dans le cache L1 pendant
+// qu'on y ajoute les contributions de tous les points de la référence
+#define TUILE_LIGNES	16
+#define TUILE_COLONNES	128
+// Découpage de la méthode FFT en tâches : blocs de lignes (pair) et de colonnes du spectre
+#define BLOC_LIGNES_FFT		16
+#define BLOC_COLONNES_FFT	16
+// Recherche exacte du maximum par élimination successive (chercherMaximum) : l'espace centré est
+// découpé en cellules de TAILLE_CELLULE_ELIMINATION x TAILLE_CELLULE_ELIMINATION décalages (une
+// puissance de 2), divisées en 4 tant que leur borne peut dépasser le meilleur score trouvé.
+// La borne d'une cellule de taille t utilise des blocs de la référence de max(t, BLOC_ELIMINATION_MIN) px.
+#define TAILLE_CELLULE_ELIMINATION	64
+#define NIVEAUX_ELIMINATION			7		// log2(TAILLE_CELLULE_ELIMINATION) + 1
+#define BLOC_ELIMINATION_MIN		8
+#define TRAVAIL_MAX_ELIMINATION		0.5		// fraction du travail de correler() (corrélation complète) avant abandon
+// Coûts mesurés (essai "elimination" de banc_essai), en multiplications-additions de la méthode directe :
+#define COUT_UNITE_ELIMINATION		16		// un bloc d'une borne ou un point d'un score exact (lectures dispersées)
+#define COUT_FFT					3.4		// méthode FFT, par P Q log2(P Q) (taille des transformées)
+#define COUT_SEGMENT				1.5		// méthode segments, par décalage et par segment
+// Rapport pic/lobes (taillesLobes) : les lobes sont les blocs qui recouvrent le carré de +/- FRACTION_LOBES_PIC x la taille
+// de la référence autour du pic, moins le carré de +/- FRACTION_EXCLUSION_PIC x la taille (pic lui-même)
+#define FRACTION_LOBES_PIC		0.1
+#define FRACTION_EXCLUSION_PIC	0.02
+#define EXCLUSION_PIC_MIN		3		// en px
+// Les sommes des lobes sont faites par blocs de BLOC_LOBES x BLOC_LOBES points de l'espace, au moment
+// où chaque tâche écrit sa partie (doit diviser TUILE_LIGNES, TUILE_COLONNES et BLOC_LIGNES_FFT)
+#define BLOC_LOBES				8
+
+typedef enum {
+	CORRELATION_DIRECTE,	// Corrélation spatiale, seulement sur les décalages de l'espace centré
+	CORRELATION_FFT,		// Corrélation dans l'espace des fréquences (correlation_fft_centree)
+	CORRELATION_SEGMENTS,	// Comme la méthode directe, mais tous les points de la référence ont le même
+							// poids : chaque segment horizontal de l'anneau est une différence de
+							// sommes cumulées d'une ligne de l'objet
+} MethodeCorrelation;
+
+typedef enum {
+	PRECISION_DOUBLE,		// Calcul en MonDouble (double)
+	PRECISION_SIMPLE		// Calcul de la méthode directe en float : deux fois plus de valeurs par
+							// instruction SIMD et deux fois moins de mémoire lue
+} PrecisionCorrelation;
+
+typedef enum {
+	NORMALISATION_MAX,		// Espace divisé par son maximum (valeurs de 0 à INTENSITE_MAX)
+	NORMALISATION_ZNCC		// Corrélation normalisée centrée : chaque décalage est centré et divisé par les
+							// écarts types de la référence et de la partie de l'objet qu'elle recouvre
+							// (score entre -1 et 1, qui ne dépend pas de la luminosité de l'image)
+} NormalisationCorrelation;
+
+/**
+ * Point de la référence gardé après seuillage : décalage par rapport au centre
+ * de la référence et poids (MonDouble ou float)
+ */
+template<typename T> struct PointReference {
+	int l, c;
+	T poids;
+};
+
+/**
+ * Bloc carré de la référence (recherche par élimination successive) : coin par rapport
+ * au centre de la référence, plus grand poids et norme (racine de la somme des carrés)
+ * des poids de ses points
+ */
+struct BlocReference {
+	int l, c;
+	MonDouble poids_max, norme;
+};
+
+/**
+ * Cellule de l'espace des décalages : [l, l+2^niveau[ x [c, c+2^niveau[ et majorant du
+ * score de tous ses décalages
+ */
+struct CelluleDecalages {
+	int l, c, niveau;
+	double borne;
+};
+
+class Correlateur {
+private:
+	MethodeCorrelation methode;
+	Image* ref;			// Référence normalisée et seuillée (poids de la corrélation)
+	PointReference<MonDouble>* points; // Points non nuls de ref, ligne par ligne (méthode directe)
+	PointReference<float>* points_simple;
+	int nb_points;
+	CorrelateurSegments* segments; // CORRELATION_SEGMENTS seulement (NULL sinon)
+	// Élimination successive : blocs de la référence pour les cellules de taille 2^k (niveau k)
+	BlocReference* blocs_elimination[NIVEAUX_ELIMINATION];
+	int nb_blocs_elimination[NIVEAUX_ELIMINATION];
+	MonDouble* integrale_obj;	// Somme des pixels de l'objet au dessus et à gauche, (lignes+1) x (colonnes+1)
+	MonDouble* integrale_carres_obj; // Idem pour les carrés des pixels
+	int taille_integrale_obj, integrale_lignes, integrale_colonnes;
+	CelluleDecalages* tas;		// Cellules à examiner, la plus grande borne en premier
+	int taille_tas, nb_cellules;
+	PrecisionCorrelation precision;
+	NormalisationCorrelation normalisation;
+	// NORMALISATION_ZNCC : moyenne des poids de ref (sur tout son rectangle) et norme des poids centrés
+	double moyenne_ref, norme_ref;
+	float* obj_simple;	// Objet converti en float (PRECISION_SIMPLE)
+	float* dst_simple;	// Espace de corrélation en float (PRECISION_SIMPLE)
+	int taille_obj_simple, taille_dst_simple;
+	int lignes, colonnes;	// Taille des images objet pour laquelle les espaces de travail sont prêts
+	Image* sortie;		// Espace de corrélation centré, de la taille de l'objet
+	Image* fenetre;		// Partie de l'espace centré calculée par correlerFenetre()
+	int fenetre_l, fenetre_c; // Coordonnées dans l'espace centré du point (0,0) de la fenêtre
+	Image* dernier_espace;	// sortie ou fenetre, selon le dernier calcul (pour rapportPicLobes())
+	int demi_lobes, demi_exclusion; // en px, demi-côtés des carrés de rapportPicLobes()
+	// Somme des valeurs (et de leurs carrés) de dernier_espace par bloc de BLOC_LOBES x BLOC_LOBES,
+	// avant la normalisation par le maximum (facteur_lobes)
+	MonDouble* sommes_lobes;
+	MonDouble* carres_lobes;
+	int taille_lobes, blocs_lobes_colonnes;
+	double facteur_lobes;
+
+	// Espaces de travail de la méthode FFT
+	PlanFFT* plan_lignes;
+	PlanFFT* plan_colonnes;
+	double* spectre_ref;	// Spectre de la référence (calculé une fois par taille d'objet)
+	double* spectre_obj;
+	double* tampon;		// Un tampon de travail par thread
+
+	// Calcul en parallèle (NULL : tout est calculé par le thread appelant)
+	ThreadsCalcul* threads;
+	int nb_threads;
+	// Paramètres de la corrélation en cours, lus par les tâches
+	Image* tache_obj;
+	Image* tache_dst;
+	int tache_l_0, tache_c_0;
+
+	void preparer(int lignes, int colonnes);
+	void liberer();
+	void executer(TacheCalcul tache, int nb_taches);
+	void correlerDirecte(Image& obj, int l_0, int c_0, Image& dst);
+	void correlerTuile(Image& obj, int l_0, int c_0, Image& dst, int l_tuile, int c_tuile, int l_fin_tuile, int c_fin_tuile);
+	void correlerFFT(Image& obj);
+	void normaliserZNCC(Image& obj, int l_0, int c_0, Image& dst);
+	void preparerLobes(Image& dst);
+	void sommerLobes(Image& dst, int l_deb, int l_fin, int c_deb, int c_fin);
+	void preparerElimination();
+	void calculerIntegraleObjet(Image& obj);
+	double borneCellule(int l, int c, int niveau);
+	double scoreDecalage(const MonDouble* obj, int l, int c);
+	double travailCorrelation(int lignes, int colonnes);
+	void ajouterCellule(int l, int c, int niveau, double borne);
+	CelluleDecalages retirerCellule();
+	static void tacheTuile(void* correlateur, int indice, int num_thread);
+	static void tacheLignesFFT(void* correlateur, int indice, int num_thread);
+	static void tacheColonnesFFT(void* correlateur, int indice, int num_thread);
+	static void tacheLignesFFTInverse(void* correlateur, int indice, int num_thread);
+	static void tacheLignesZNCC(void* correlateur, int indice, int num_thread);
+public:
+	Correlateur(Image& reference, float seuil_ref, MethodeCorrelation methode, ThreadsCalcul* threads = NULL,
+			PrecisionCorrelation precision = PRECISION_DOUBLE, NormalisationCorrelation normalisation = NORMALISATION_MAX);
+	~Correlateur();
+	Image* correler(Image& obj);
+	Image* correlerFenetre(Image& obj, int l_centre, int c_centre, int demi_taille);
+	bool chercherMaximum(Image& obj, int *l, int *c);
+	double rapportPicLobes(int l, int c);
+	static void taillesLobes(int taille_ref, int *demi_lobes, int *demi_exclusion);
+	void centreVersPic(double *l, double *c);
+	int getDemiLobes() { return demi_lobes; }
+	int getDemiExclusion() { return demi_exclusion; }
+	int getFenetreLigne() { return fenetre_l; }
+	int getFenetreColonne() { return fenetre_c; }
+	MethodeCorrelation getMethode() { return methode; }
+	PrecisionCorrelation getPrecision() { return precision; }
+	NormalisationCorrelation getNormalisation() { return normalisation; }
+	int getNombrePoints() { return nb_points; }
+	int getNombreSegments() { return segments ? segments->getNombreSegments() : 0; }
+};
+
+#endif /* CORRELATEUR_H_ */
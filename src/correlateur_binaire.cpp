@@ -0,0 +1,220 @@
+/*
+ * correlateur_binaire.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Un mot de 64 bits lu dans une ligne des contours de l'objet, à partir de la colonne
+ *  c + (décalage d'un point de la référence), dit pour les 64 décalages c à c+63 si ce
+ *  point tombe sur un contour. Les 64 scores sont des compteurs "en tranches" : le bit t
+ *  du mot compteurs[b] est le bit b du score du décalage c+t. Ajouter un point coûte
+ *  donc quelques ET/OU exclusifs pour 64 décalages, au lieu de 64 multiplications-additions.
+ *
+ *  Les contours de l'objet sont dilatés d'un pixel : un anneau d'un pixel d'épaisseur
+ *  décalé d'un pixel garde ainsi presque tout son score, et le pic grossier est à un
+ *  pixel près de celui de la corrélation complète.
+ */
+
+#include "correlateur_binaire.h"
+#include "correlateur.h"
+
+/**
+ * @param reference L'image de référence (laplacien de la forme du soleil)
+ * @param seuil_ref Seuil entre 0 et 1 : les pixels gardés par Image::referenceSeuillee sont à 1
+ * @param threads Les threads qui se partagent les lignes de l'espace des scores (NULL pour tout
+ * calculer dans le thread appelant) ; ils ne doivent pas être détruits avant le CorrelateurBinaire
+ */
+CorrelateurBinaire::CorrelateurBinaire(Image& reference, float seuil_ref, ThreadsCalcul* threads) {
+	this->threads = threads;
+	obj_bits = NULL;
+	contour = NULL;
+	scores_blocs = l_blocs = c_blocs = NULL;
+	nb_blocs = 0;
+	lignes = colonnes = 0;
+	mots_par_ligne = 0;
+
+	Image* ref = reference.referenceSeuillee(seuil_ref);
+	ref_lignes = ref->getLignes();
+	ref_colonnes = ref->getColonnes();
+	marge_lignes = ref_lignes;
+	marge_mots = ref_colonnes/64 + 2;
+	nb_points = 0;
+	points_l = new int[ref_lignes*ref_colonnes];
+	points_c = new int[ref_lignes*ref_colonnes];
+	for (int l=0; l < ref_lignes; l++) {
+		for (int c=0; c < ref_colonnes; c++) {
+			if(ref->getPix(l,c) > 0) {
+				points_l[nb_points] = l - (ref_lignes-1-ref_lignes/2);
+				points_c[nb_points] = c - (ref_colonnes-1-ref_colonnes/2);
+				nb_points++;
+			}
+		}
+	}
+	bits_compteurs = 1;
+	while((1 << bits_compteurs) <= nb_points) bits_compteurs++;
+	delete ref;
+}
+
+CorrelateurBinaire::~CorrelateurBinaire() {
+	liberer();
+	delete [] points_l;
+	delete [] points_c;
+}
+
+void CorrelateurBinaire::liberer() {
+	if(obj_bits) delete [] obj_bits;
+	if(contour) delete [] contour;
+	if(scores_blocs) delete [] scores_blocs;
+	if(l_blocs) delete [] l_blocs;
+	if(c_blocs) delete [] c_blocs;
+	obj_bits = NULL;
+	contour = NULL;
+	scores_blocs = l_blocs = c_blocs = NULL;
+	lignes = colonnes = 0;
+}
+
+/**
+ * Alloue les espaces de travail pour des images objet de taille lignes x colonnes ;
+ * ne fait rien si c'est déjà le cas
+ */
+void CorrelateurBinaire::preparer(int lignes, int colonnes) {
+	if(lignes == this->lignes && colonnes == this->colonnes) {
+		return;
+	}
+	liberer();
+	this->lignes = lignes;
+	this->colonnes = colonnes;
+	mots_par_ligne = 2*marge_mots + (colonnes + 63)/64;
+	obj_bits = new uint64_t[(lignes + 2*marge_lignes) * mots_par_ligne];
+	for (int i=0; i < (lignes + 2*marge_lignes) * mots_par_ligne; i++) {
+		obj_bits[i] = 0; // les marges restent nulles
+	}
+	contour = new unsigned char[lignes*colonnes];
+	nb_blocs = (lignes + BLOC_LIGNES_BINAIRE-1)/BLOC_LIGNES_BINAIRE;
+	scores_blocs = new int[nb_blocs];
+	l_blocs = new int[nb_blocs];
+	c_blocs = new int[nb_blocs];
+}
+
+/**
+ * Contours de l'objet : pixels au dessus de seuil_relatif fois le maximum (et d'au moins
+ * 3 fois la moyenne, celle du bruit), dilatés d'un pixel, rangés dans obj_bits
+ */
+void CorrelateurBinaire::binariser(Image& obj, double seuil_relatif) {
+	const MonDouble* p = obj.ptr();
+	double somme = 0;
+	for (int i=0; i < lignes*colonnes; i++) {
+		somme += p[i];
+	}
+	MonDouble seuil = max(seuil_relatif * obj.valeurMax(), 3 * somme/(lignes*colonnes));
+	for (int i=0; i < lignes*colonnes; i++) {
+		contour[i] = p[i] > seuil;
+	}
+	for (int l=0; l < lignes; l++) {
+		uint64_t* ligne_bits = obj_bits + (l + marge_lignes)*mots_par_ligne;
+		for (int k=marge_mots; k < mots_par_ligne - marge_mots; k++) {
+			ligne_bits[k] = 0;
+		}
+		for (int c=0; c < colonnes; c++) {
+			bool allume = false;
+			for (int dl = max(0, l-1); dl <= min(lignes-1, l+1) && !allume; dl++) {
+				for (int dc = max(0, c-1); dc <= min(colonnes-1, c+1); dc++) {
+					if(contour[dl*colonnes + dc]) {
+						allume = true;
+						break;
+					}
+				}
+			}
+			if(allume) {
+				int x = c + marge_mots*64;
+				ligne_bits[x >> 6] |= (uint64_t)1 << (x & 63);
+			}
+		}
+	}
+}
+
+/**
+ * Scores d'un bloc de lignes de l'espace des décalages (même espace que la corrélation
+ * centrée : le point (l,c) est le décalage où le centre de la référence est sur le point
+ * (l,c) de l'objet) ; garde le meilleur du bloc
+ */
+void CorrelateurBinaire::chercherDansBloc(int indice) {
+	uint64_t compteurs[32];
+	int l_fin = min((indice+1)*BLOC_LIGNES_BINAIRE, lignes);
+	int meilleur = -1, l_meilleur = 0, c_meilleur = 0;
+	for (int l = indice*BLOC_LIGNES_BINAIRE; l < l_fin; l++) {
+		for (int c_bloc=0; c_bloc < colonnes; c_bloc += 64) {
+			for (int b=0; b < bits_compteurs; b++) {
+				compteurs[b] = 0;
+			}
+			for (int i=0; i < nb_points; i++) {
+				// Les 64 bits à partir de la colonne c_bloc + points_c[i] de la ligne l + points_l[i]
+				const uint64_t* ligne = obj_bits + (l + points_l[i] + marge_lignes)*mots_par_ligne;
+				int x = c_bloc + points_c[i] + marge_mots*64;
+				int q = x >> 6, s = x & 63;
+				uint64_t retenue = (s == 0) ? ligne[q] : (ligne[q] >> s) | (ligne[q+1] << (64-s));
+				// Addition de 1 aux compteurs des décalages dont le bit est à 1
+				for (int b=0; retenue != 0; b++) {
+					uint64_t t = compteurs[b] & retenue;
+					compteurs[b] ^= retenue;
+					retenue = t;
+				}
+			}
+			int nb_decalages = min(64, colonnes - c_bloc);
+			for (int t=0; t < nb_decalages; t++) {
+				int score = 0;
+				for (int b=0; b < bits_compteurs; b++) {
+					score |= (int)((compteurs[b] >> t) & 1) << b;
+				}
+				if(score > meilleur) {
+					meilleur = score;
+					l_meilleur = l;
+					c_meilleur = c_bloc + t;
+				}
+			}
+		}
+	}
+	scores_blocs[indice] = meilleur;
+	l_blocs[indice] = l_meilleur;
+	c_blocs[indice] = c_meilleur;
+}
+
+void CorrelateurBinaire::tacheBloc(void* contexte, int indice, int /* num_thread */) {
+	((CorrelateurBinaire*)contexte)->chercherDansBloc(indice);
+}
+
+/**
+ * Recherche grossière du décalage qui recouvre le plus de pixels du contour
+ * @param obj L'image objet (dérivée de l'image capturée)
+ * @param seuil_relatif Seuil des contours de l'objet, entre 0 et 1 (fraction du maximum)
+ * @param l Position trouvée (au pixel près) dans l'espace centré
+ * @param c
+ * @param score Nombre de pixels de la référence sur un contour de l'objet
+ * @return false si aucun pixel ne se recouvre
+ */
+bool CorrelateurBinaire::chercher(Image& obj, double seuil_relatif, int *l, int *c, int *score) {
+	preparer(obj.getLignes(), obj.getColonnes());
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	binariser(obj, seuil_relatif);
+	if(threads) {
+		threads->executer(tacheBloc, this, nb_blocs);
+	} else {
+		for (int k=0; k < nb_blocs; k++) {
+			chercherDansBloc(k);
+		}
+	}
+	int meilleur = 0;
+	for (int k=1; k < nb_blocs; k++) {
+		if(scores_blocs[k] > scores_blocs[meilleur]) {
+			meilleur = k;
+		}
+	}
+	*l = l_blocs[meilleur];
+	*c = c_blocs[meilleur];
+	*score = scores_blocs[meilleur];
+#if DEBUG
+	printf ("Temps recherche binaire = %4.3f s (score %d)\n", (double)(clock() - temps_calcul) /CLOCKS_PER_SEC, *score);
+#endif
+	return *score > 0;
+}
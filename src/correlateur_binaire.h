@@ -0,0 +1,52 @@
+/*
+ * correlateur_binaire.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Recherche grossière de la position du soleil sur des images binaires : les contours
+ *  de l'objet sont rangés à raison de 64 pixels par mot, et le score d'un décalage est
+ *  le nombre de pixels de la référence seuillée qui tombent sur un contour. Les scores
+ *  de 64 décalages voisins sont calculés ensemble, un bit par décalage.
+ *  Le pic trouvé est ensuite affiné par la corrélation complète dans une petite fenêtre
+ *  (voir Capture::trouverPositionParBinaire).
+ */
+
+#ifndef CORRELATEUR_BINAIRE_H_
+#define CORRELATEUR_BINAIRE_H_
+
+#include <stdint.h>
+#include "image.h"
+#include "threads_calcul.h"
+
+#define BLOC_LIGNES_BINAIRE	8	// Lignes de l'espace des scores par tâche
+
+class CorrelateurBinaire {
+private:
+	int ref_lignes, ref_colonnes;
+	// Points de la référence au dessus du seuil (décalage par rapport au centre)
+	int *points_l, *points_c;
+	int nb_points;
+	int bits_compteurs;		// Nombre de bits des compteurs (nb_points doit tenir)
+	// Contours de l'objet, complétés par des zéros autour (pas de test de bord)
+	uint64_t* obj_bits;
+	int lignes, colonnes;	// Taille des images objet pour laquelle obj_bits est prêt
+	int mots_par_ligne, marge_lignes, marge_mots;
+	unsigned char* contour;
+	ThreadsCalcul* threads;
+	// Meilleur score de chaque bloc de lignes (tâches)
+	int *scores_blocs, *l_blocs, *c_blocs;
+	int nb_blocs;
+
+	void preparer(int lignes, int colonnes);
+	void liberer();
+	void binariser(Image& obj, double seuil_relatif);
+	void chercherDansBloc(int indice);
+	static void tacheBloc(void* contexte, int indice, int num_thread);
+public:
+	CorrelateurBinaire(Image& reference, float seuil_ref, ThreadsCalcul* threads = NULL);
+	~CorrelateurBinaire();
+	bool chercher(Image& obj, double seuil_relatif, int *l, int *c, int *score);
+	int getNombrePoints() { return nb_points; }
+};
+
+#endif /* CORRELATEUR_BINAIRE_H_ */
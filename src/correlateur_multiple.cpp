@@ -0,0 +1,166 @@
+/*
+ * correlateur_multiple.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Même calcul que la méthode FFT du Correlateur (l'espace centré est le même), mais
+ *  les FFT sont dimensionnées pour la plus grande des références : le spectre de l'objet
+ *  sert alors pour toutes. Chaque référence est une tâche (produit des spectres, FFT
+ *  inverse, pic et signal/bruit) qui n'utilise que les espaces de travail de son thread,
+ *  le résultat ne dépend donc pas du nombre de threads.
+ */
+
+#include "correlateur_multiple.h"
+
+/**
+ * @param references Les références (laplacien de la forme du soleil), recopiées
+ * @param nb_references
+ * @param seuil_ref Le seuil minimal de prise en compte des valeurs des pixels des références, entre 0 et 1
+ * @param threads Les threads qui se partagent les références (NULL pour tout calculer dans
+ * le thread appelant) ; ils ne doivent pas être détruits avant le CorrelateurMultiple
+ */
+CorrelateurMultiple::CorrelateurMultiple(Image** references, int nb_references, float seuil_ref, ThreadsCalcul* threads) {
+	this->nb_references = nb_references;
+	this->references = new Image*[nb_references];
+	spectres_ref = new double*[nb_references];
+	for (int k=0; k < nb_references; k++) {
+		this->references[k] = references[k]->referenceSeuillee(seuil_ref);
+		spectres_ref[k] = NULL;
+	}
+	this->threads = threads;
+	nb_threads = threads ? threads->getNombreThreads() : 1;
+	lignes = colonnes = 0;
+	plan_lignes = plan_colonnes = NULL;
+	spectre_obj = produits = tampons = NULL;
+	sorties = NULL;
+	tache_resultats = NULL;
+}
+
+CorrelateurMultiple::~CorrelateurMultiple() {
+	liberer();
+	for (int k=0; k < nb_references; k++) {
+		delete references[k];
+	}
+	delete [] references;
+	delete [] spectres_ref;
+}
+
+/**
+ * Libère les espaces de travail
+ */
+void CorrelateurMultiple::liberer() {
+	for (int k=0; k < nb_references; k++) {
+		if(spectres_ref[k]) delete [] spectres_ref[k];
+		spectres_ref[k] = NULL;
+	}
+	if(sorties) {
+		for (int t=0; t < nb_threads; t++) {
+			delete sorties[t];
+		}
+		delete [] sorties;
+	}
+	if(spectre_obj) delete [] spectre_obj;
+	if(produits) delete [] produits;
+	if(tampons) delete [] tampons;
+	fft_detruire_plan(plan_lignes);
+	fft_detruire_plan(plan_colonnes);
+	sorties = NULL;
+	spectre_obj = produits = tampons = NULL;
+	plan_lignes = plan_colonnes = NULL;
+	lignes = colonnes = 0;
+}
+
+/**
+ * Alloue les espaces de travail et calcule les spectres des références pour des images
+ * objet de taille lignes x colonnes ; ne fait rien si c'est déjà le cas
+ */
+void CorrelateurMultiple::preparer(int lignes, int colonnes) {
+	if(lignes == this->lignes && colonnes == this->colonnes) {
+		return;
+	}
+	liberer();
+	this->lignes = lignes;
+	this->colonnes = colonnes;
+	// Taille minimale pour qu'aucun espace centré ne soit touché par le recouvrement circulaire
+	// (voir Correlateur::preparer), pour la plus grande des références
+	int ref_lignes_max = 0, ref_colonnes_max = 0;
+	for (int k=0; k < nb_references; k++) {
+		ref_lignes_max = max(ref_lignes_max, references[k]->getLignes());
+		ref_colonnes_max = max(ref_colonnes_max, references[k]->getColonnes());
+	}
+	plan_lignes = fft_creer_plan(fft_taille_optimale(lignes + ref_lignes_max/2));
+	plan_colonnes = fft_creer_plan(fft_taille_optimale(max(colonnes + ref_colonnes_max/2, 2)));
+	int P = plan_lignes->n, Q = plan_colonnes->n, M = Q/2+1;
+	spectre_obj = new double[P*2*M];
+	produits = new double[nb_threads*P*2*M];
+	tampons = new double[nb_threads*2*Q];
+	sorties = new Image*[nb_threads];
+	for (int t=0; t < nb_threads; t++) {
+		sorties[t] = new Image(lignes, colonnes);
+	}
+	for (int k=0; k < nb_references; k++) {
+		spectres_ref[k] = new double[P*2*M];
+		fft_2d_reelle(plan_lignes, plan_colonnes, references[k]->ptr(), references[k]->getLignes(),
+				references[k]->getColonnes(), references[k]->getColonnes(), spectres_ref[k], tampons);
+	}
+}
+
+/**
+ * Corrèle l'objet avec chacune des références
+ * @param obj L'image objet (dérivée de l'image capturée)
+ * @param resultats Tableau de getNombreReferences() résultats, dans l'ordre des références
+ */
+void CorrelateurMultiple::correler(Image& obj, ResultatCorrelation* resultats) {
+	preparer(obj.getLignes(), obj.getColonnes());
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	fft_2d_reelle(plan_lignes, plan_colonnes, obj.ptr(), lignes, colonnes, colonnes, spectre_obj, tampons);
+	tache_resultats = resultats;
+	if(threads) {
+		threads->executer(tacheReference, this, nb_references);
+	} else {
+		for (int k=0; k < nb_references; k++) {
+			correlerReference(k, 0);
+		}
+	}
+#if DEBUG
+	printf ("Temps correlation multiple (%d references) = %4.2f s\n", nb_references,
+			(double)(clock() - temps_calcul) /CLOCKS_PER_SEC);
+#endif
+}
+
+/**
+ * Corrélation avec la référence "indice" dans les espaces de travail du thread "num_thread" :
+ * produit TF(obj) x conj(TF(ref)), FFT inverse vers l'espace centré, puis pic et rapport pic/lobes
+ * (l'espace est normalisé comme dans Correlateur::correler)
+ */
+void CorrelateurMultiple::correlerReference(int indice, int num_thread) {
+	int P = plan_lignes->n, Q = plan_colonnes->n, M = Q/2+1;
+	double *produit = produits + num_thread*P*2*M;
+	const double *ref_pt = spectres_ref[indice];
+	for (int k=0; k < P*M; k++) {
+		double o_re = spectre_obj[2*k], o_im = spectre_obj[2*k+1];
+		double r_re = ref_pt[2*k], r_im = ref_pt[2*k+1];
+		produit[2*k] = o_re*r_re + o_im*r_im;
+		produit[2*k+1] = o_im*r_re - o_re*r_im;
+	}
+	int ref_lignes = references[indice]->getLignes(), ref_colonnes = references[indice]->getColonnes();
+	Image* sortie = sorties[num_thread];
+	fft_2d_reelle_inverse(plan_lignes, plan_colonnes, produit, sortie->ptr(),
+			-(ref_lignes-1-ref_lignes/2), lignes, -(ref_colonnes-1-ref_colonnes/2), colonnes, colonnes,
+			tampons + num_thread*2*Q);
+	sortie->reinitialiserMinMax();
+	if(sortie->valeurMax() > 0) { // pas d'image (ciel couvert) : espace laissé tel quel
+		sortie->multiplier(INTENSITE_MAX / sortie->valeurMax());
+	}
+	ResultatCorrelation* resultat = &tache_resultats[indice];
+	sortie->maxParInterpolation(&resultat->l, &resultat->c);
+	int demi_lobes, demi_exclusion;
+	Correlateur::taillesLobes(max(ref_lignes, ref_colonnes), &demi_lobes, &demi_exclusion);
+	resultat->signalbruit = sortie->rapportPicLobes(sortie->posMaxLigne(), sortie->posMaxColonne(), demi_lobes, demi_exclusion);
+}
+
+void CorrelateurMultiple::tacheReference(void* contexte, int indice, int num_thread) {
+	((CorrelateurMultiple*)contexte)->correlerReference(indice, num_thread);
+}
@@ -0,0 +1,56 @@
+/*
+ * correlateur_multiple.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Corrélation d'une même image objet avec plusieurs références (par exemple la forme
+ *  du soleil pour plusieurs diamètres, Capture::chercherDiametreProche) : le spectre de
+ *  l'objet n'est calculé qu'une fois et les références sont corrélées en parallèle.
+ */
+
+#ifndef CORRELATEUR_MULTIPLE_H_
+#define CORRELATEUR_MULTIPLE_H_
+
+#include "image.h"
+#include "correlateur.h"
+#include "threads_calcul.h"
+
+/**
+ * Résultat de la corrélation avec une référence : position sous-pixel du pic dans
+ * l'espace centré (donc dans l'objet) et rapport pic/lobes (Image::rapportPicLobes, carrés
+ * proportionnels à la taille de la référence comme pour le Correlateur)
+ */
+typedef struct {
+	double l, c;
+	double signalbruit;
+} ResultatCorrelation;
+
+class CorrelateurMultiple {
+private:
+	int nb_references;
+	Image** references;		// Références normalisées et seuillées
+	double** spectres_ref;	// Un spectre par référence (calculés une fois par taille d'objet)
+	int lignes, colonnes;	// Taille des images objet pour laquelle les espaces de travail sont prêts
+	PlanFFT* plan_lignes;
+	PlanFFT* plan_colonnes;
+	double* spectre_obj;	// Partagé par toutes les références (lu seulement par les tâches)
+	// Espaces de travail propres à chaque thread
+	ThreadsCalcul* threads;
+	int nb_threads;
+	double* produits;		// Produit des spectres
+	double* tampons;
+	Image** sorties;		// Espace de corrélation centré
+	ResultatCorrelation* tache_resultats;
+
+	void preparer(int lignes, int colonnes);
+	void liberer();
+	void correlerReference(int indice, int num_thread);
+	static void tacheReference(void* contexte, int indice, int num_thread);
+public:
+	CorrelateurMultiple(Image** references, int nb_references, float seuil_ref, ThreadsCalcul* threads = NULL);
+	~CorrelateurMultiple();
+	void correler(Image& obj, ResultatCorrelation* resultats);
+	int getNombreReferences() { return nb_references; }
+};
+
+#endif /* CORRELATEUR_MULTIPLE_H_ */
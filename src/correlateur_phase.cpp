@@ -0,0 +1,125 @@
+/*
+ * correlateur_phase.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Corrélation de phase : avec O et R les spectres de l'objet et de la référence,
+ *  l'espace de corrélation est la transformée inverse de O.conj(R) / |O.conj(R)|.
+ *  Seule la phase du spectre croisé est gardée : le pic est très fin et ne dépend
+ *  pas de l'intensité des images (voile, variations lentes de luminosité).
+ *
+ *  Les images utilisées sont les dérivées (convoluerParDerivee) : leurs bords sont nuls,
+ *  le complément par des zéros jusqu'à la taille des FFT ne crée donc pas de discontinuité.
+ */
+
+#include "correlateur_phase.h"
+#include <cmath>
+
+CorrelateurPhase::CorrelateurPhase() {
+	lignes = colonnes = 0;
+	plan_lignes = plan_colonnes = NULL;
+	spectre_ref = spectre_obj = tampon = NULL;
+	sortie = NULL;
+	ref_l = ref_c = 0;
+}
+
+CorrelateurPhase::~CorrelateurPhase() {
+	liberer();
+}
+
+void CorrelateurPhase::liberer() {
+	if(sortie) delete sortie;
+	if(spectre_ref) delete [] spectre_ref;
+	if(spectre_obj) delete [] spectre_obj;
+	if(tampon) delete [] tampon;
+	fft_detruire_plan(plan_lignes);
+	fft_detruire_plan(plan_colonnes);
+	sortie = NULL;
+	plan_lignes = plan_colonnes = NULL;
+	spectre_ref = spectre_obj = tampon = NULL;
+	lignes = colonnes = 0;
+}
+
+/**
+ * Enregistre l'image de référence (son spectre) et la position du soleil dans cette image
+ * @param ref La dérivée de l'image de référence
+ * @param l Position du soleil dans la référence
+ * @param c
+ */
+void CorrelateurPhase::definirReference(Image& ref, double l, double c) {
+	if(ref.getLignes() != lignes || ref.getColonnes() != colonnes) {
+		liberer();
+		lignes = ref.getLignes();
+		colonnes = ref.getColonnes();
+		plan_lignes = fft_creer_plan(fft_taille_optimale(max(lignes, 2)));
+		plan_colonnes = fft_creer_plan(fft_taille_optimale(max(colonnes, 2)));
+		int P = plan_lignes->n, M = plan_colonnes->n/2+1;
+		spectre_ref = new double[P*2*M];
+		spectre_obj = new double[P*2*M];
+		tampon = new double[2*plan_colonnes->n];
+		sortie = new Image(lignes, colonnes);
+	}
+	fft_2d_reelle(plan_lignes, plan_colonnes, ref.ptr(), lignes, colonnes, colonnes, spectre_ref, tampon);
+	ref_l = l;
+	ref_c = c;
+}
+
+/**
+ * Corrélation de phase de l'objet avec la référence
+ * @param obj La dérivée de l'image courante (même taille que la référence)
+ * @return L'espace de corrélation de phase, qui appartient au CorrelateurPhase ; le point
+ * (lignes/2, colonnes/2) correspond à un décalage nul. NULL s'il n'y a pas de référence
+ * ou si la taille de l'objet n'est pas celle de la référence.
+ */
+Image* CorrelateurPhase::correler(Image& obj) {
+	if(!aUneReference() || obj.getLignes() != lignes || obj.getColonnes() != colonnes) {
+		return NULL;
+	}
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	int P = plan_lignes->n, M = plan_colonnes->n/2+1;
+	fft_2d_reelle(plan_lignes, plan_colonnes, obj.ptr(), lignes, colonnes, colonnes, spectre_obj, tampon);
+	// Spectre croisé O x conj(R) normalisé
+	for (int k=0; k < P*M; k++) {
+		double o_re = spectre_obj[2*k], o_im = spectre_obj[2*k+1];
+		double r_re = spectre_ref[2*k], r_im = spectre_ref[2*k+1];
+		double re = o_re*r_re + o_im*r_im;
+		double im = o_im*r_re - o_re*r_im;
+		double module = sqrt(re*re + im*im);
+		spectre_obj[2*k] = (module > 0) ? re/module : 0;
+		spectre_obj[2*k+1] = (module > 0) ? im/module : 0;
+	}
+	fft_2d_reelle_inverse(plan_lignes, plan_colonnes, spectre_obj, sortie->ptr(),
+			-(lignes/2), lignes, -(colonnes/2), colonnes, colonnes, tampon);
+	sortie->reinitialiserMinMax();
+#if DEBUG
+	printf ("Temps correlation de phase = %4.3f s\n",  (double)(clock() - temps_calcul) /CLOCKS_PER_SEC);
+#endif
+	return sortie;
+}
+
+/**
+ * Position du soleil dans l'objet : position dans la référence + décalage mesuré
+ * @param obj La dérivée de l'image courante
+ * @param l Position trouvée
+ * @param c
+ * @param demi_lobes En px, carrés du rapport pic/lobes (Correlateur::taillesLobes)
+ * @param demi_exclusion
+ * @param signalbruit Rapport pic/lobes du pic (Image::rapportPicLobes), le même que pour la
+ * corrélation avec la forme du soleil : l'espace de corrélation de phase est centré sur 0,
+ * mais le rapport ne dépend pas du niveau moyen
+ * @return false si la corrélation est impossible (pas de référence, taille différente)
+ */
+bool CorrelateurPhase::trouverPosition(Image& obj, int demi_lobes, int demi_exclusion, double *l, double *c, double *signalbruit) {
+	Image *correl = correler(obj);
+	if(correl == NULL) {
+		return false;
+	}
+	double l_pic, c_pic;
+	correl->maxParInterpolation(&l_pic, &c_pic);
+	*signalbruit = correl->rapportPicLobes(correl->posMaxLigne(), correl->posMaxColonne(), demi_lobes, demi_exclusion);
+	*l = ref_l + l_pic - lignes/2;
+	*c = ref_c + c_pic - colonnes/2;
+	return true;
+}
@@ -0,0 +1,38 @@
+/*
+ * correlateur_phase.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Corrélation de phase : mesure du décalage entre l'image courante et une image de
+ *  référence (prise au moment du "reset" de la consigne), sans utiliser la forme
+ *  théorique du soleil (tracerFormeSoleil). Le spectre de la référence est gardé,
+ *  il ne reste donc qu'une FFT directe et une FFT inverse par image.
+ */
+
+#ifndef CORRELATEUR_PHASE_H_
+#define CORRELATEUR_PHASE_H_
+
+#include "image.h"
+
+class CorrelateurPhase {
+private:
+	int lignes, colonnes;	// Taille des images (celle de la référence)
+	PlanFFT* plan_lignes;
+	PlanFFT* plan_colonnes;
+	double* spectre_ref;	// NULL tant qu'il n'y a pas de référence
+	double* spectre_obj;
+	double* tampon;
+	Image* sortie;			// Espace de corrélation de phase, le décalage nul étant au centre
+	double ref_l, ref_c;	// Position du soleil dans l'image de référence
+
+	void liberer();
+public:
+	CorrelateurPhase();
+	~CorrelateurPhase();
+	void definirReference(Image& ref, double l, double c);
+	bool aUneReference() { return spectre_ref != NULL; }
+	Image* correler(Image& obj);
+	bool trouverPosition(Image& obj, int demi_lobes, int demi_exclusion, double *l, double *c, double *signalbruit);
+};
+
+#endif /* CORRELATEUR_PHASE_H_ */
@@ -0,0 +1,109 @@
+/*
+ * correlateur_segments.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Les segments sont extraits une fois de la référence ; les sommes cumulées des lignes
+ *  de l'objet sont recalculées à chaque image par preparerObjet(), avant que les tâches
+ *  du Correlateur appellent correlerTuile() (chacune sur sa tuile de dst).
+ */
+
+#include "correlateur_segments.h"
+
+/**
+ * @param ref La référence seuillée du Correlateur, aux poids déjà rendus égaux (anneau plat)
+ */
+CorrelateurSegments::CorrelateurSegments(Image& ref) {
+	int ref_lignes = ref.getLignes(), ref_colonnes = ref.getColonnes();
+	int nb_points = 0;
+	for (int i=0; i < ref_lignes*ref_colonnes; i++) {
+		if(ref.ptr()[i] > 0) nb_points++;
+	}
+	// Points consécutifs de même poids sur une ligne (un ou deux segments par ligne pour
+	// l'anneau plat, au lieu de l'épaisseur de l'anneau en points)
+	nb_segments = 0;
+	segments = new SegmentReference[max(nb_points, 1)];
+	for (int l=0; l < ref_lignes; l++) {
+		for (int c=0; c < ref_colonnes; c++) {
+			MonDouble poids = ref.getPix(l,c);
+			if(poids <= 0) {
+				continue;
+			}
+			int c_fin = c+1;
+			while(c_fin < ref_colonnes && ref.getPix(l,c_fin) == poids) c_fin++;
+			segments[nb_segments].l = l - (ref_lignes-1-ref_lignes/2);
+			segments[nb_segments].c_deb = c - (ref_colonnes-1-ref_colonnes/2);
+			segments[nb_segments].c_fin = c_fin - (ref_colonnes-1-ref_colonnes/2);
+			segments[nb_segments].poids = poids;
+			nb_segments++;
+			c = c_fin-1;
+		}
+	}
+	sommes_obj = NULL;
+	taille_sommes_obj = largeur_sommes = obj_lignes = 0;
+	marge_sommes = ref_colonnes;
+}
+
+CorrelateurSegments::~CorrelateurSegments() {
+	delete [] segments;
+	if(sommes_obj) delete [] sommes_obj;
+}
+
+/**
+ * Sommes cumulées des lignes de l'objet : l'élément k+marge_sommes d'une ligne est la somme
+ * des pixels de la ligne d'indice inférieur à k, k étant ramené entre 0 et colonnes. Les
+ * segments qui sortent de l'objet ne voient donc que sa partie dans l'objet, comme les
+ * points de la méthode directe.
+ */
+void CorrelateurSegments::preparerObjet(Image& obj) {
+	int obj_colonnes = obj.getColonnes();
+	obj_lignes = obj.getLignes();
+	largeur_sommes = obj_colonnes + 1 + 2*marge_sommes;
+	if(obj_lignes*largeur_sommes > taille_sommes_obj) {
+		if(sommes_obj) delete [] sommes_obj;
+		sommes_obj = new MonDouble[obj_lignes*largeur_sommes];
+		taille_sommes_obj = obj_lignes*largeur_sommes;
+	}
+	for (int l=0; l < obj_lignes; l++) {
+		const MonDouble *obj_pt = obj.ptr() + l*obj_colonnes;
+		MonDouble *somme_pt = sommes_obj + l*largeur_sommes;
+		for (int k=0; k <= marge_sommes; k++) {
+			somme_pt[k] = 0;
+		}
+		MonDouble somme = 0;
+		for (int c=0; c < obj_colonnes; c++) {
+			somme += obj_pt[c];
+			somme_pt[marge_sommes + c+1] = somme;
+		}
+		for (int k=marge_sommes + obj_colonnes+1; k < largeur_sommes; k++) {
+			somme_pt[k] = somme;
+		}
+	}
+}
+
+/**
+ * Ajoute à la tuile [l_tuile, l_fin_tuile[ x [c_tuile, c_fin_tuile[ de dst les contributions
+ * de tous les segments, chacun valant poids x (somme cumulée en fin de segment - somme en
+ * début). preparerObjet() doit avoir été appelé pour l'objet en cours.
+ * @param l_0 Coordonnées dans l'objet du point (0,0) de dst
+ * @param c_0
+ */
+void CorrelateurSegments::correlerTuile(int l_0, int c_0, Image& dst,
+		int l_tuile, int c_tuile, int l_fin_tuile, int c_fin_tuile) {
+	int dst_colonnes = dst.getColonnes();
+	for (int i=0; i < nb_segments; i++) {
+		const MonDouble poids = segments[i].poids;
+		int l_decal = l_0 + segments[i].l;
+		int l_deb = max(l_tuile, -l_decal);
+		int l_fin = min(l_fin_tuile, obj_lignes - l_decal);
+		for (int l = l_deb; l < l_fin; l++) {
+			MonDouble* __restrict dst_pt = dst.ptr() + l*dst_colonnes;
+			const MonDouble* ligne = sommes_obj + (l+l_decal)*largeur_sommes + marge_sommes + c_0;
+			const MonDouble* __restrict fin_pt = ligne + segments[i].c_fin;
+			const MonDouble* __restrict deb_pt = ligne + segments[i].c_deb;
+			for (int c = c_tuile; c < c_fin_tuile; c++) {
+				dst_pt[c] += poids * (fin_pt[c] - deb_pt[c]);
+			}
+		}
+	}
+}
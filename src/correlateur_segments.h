@@ -0,0 +1,42 @@
+/*
+ * correlateur_segments.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Méthode CORRELATION_SEGMENTS du Correlateur : tous les points gardés de la référence
+ *  ont le même poids (anneau "plat"), donc chaque segment horizontal de l'anneau apporte
+ *  poids x (différence de deux sommes cumulées d'une ligne de l'objet), au lieu d'un
+ *  produit par point. Construit par le Correlateur seulement quand cette méthode est
+ *  choisie ; le découpage en tuiles et les threads restent ceux du Correlateur.
+ */
+
+#ifndef CORRELATEUR_SEGMENTS_H_
+#define CORRELATEUR_SEGMENTS_H_
+
+#include "image.h"
+
+/**
+ * Segment horizontal de la référence (points consécutifs de même poids) : ligne et
+ * colonnes [c_deb, c_fin[ par rapport au centre de la référence
+ */
+struct SegmentReference {
+	int l, c_deb, c_fin;
+	MonDouble poids;
+};
+
+class CorrelateurSegments {
+private:
+	SegmentReference* segments;
+	int nb_segments;
+	MonDouble* sommes_obj;	// Sommes cumulées des lignes de l'objet, complétées de chaque côté
+	int taille_sommes_obj, largeur_sommes, marge_sommes;
+	int obj_lignes;		// Taille de l'objet des sommes
+public:
+	CorrelateurSegments(Image& ref);
+	~CorrelateurSegments();
+	void preparerObjet(Image& obj);
+	void correlerTuile(int l_0, int c_0, Image& dst, int l_tuile, int c_tuile, int l_fin_tuile, int c_fin_tuile);
+	int getNombreSegments() { return nb_segments; }
+};
+
+#endif /* CORRELATEUR_SEGMENTS_H_ */
@@ -88,8 +88,9 @@ FenetrePrincipale::FenetrePrincipale(QWidget *parent) :
 
 
     // Signaux-slots entre capture et guidage
-    QObject::connect(capture,SIGNAL(resultats(QImage,double,double,int,double)),guidage, SLOT(traiterResultatsCapture(QImage,double,double,int,double)));
+    QObject::connect(capture,SIGNAL(resultats(QImage,double,double,int,double,NiveauLocalisation)),guidage, SLOT(traiterResultatsCapture(QImage,double,double,int,double,NiveauLocalisation)));
     QObject::connect(capture,SIGNAL(stopperGuidage()),guidage, SLOT(stopperGuidage()));
+    QObject::connect(guidage,SIGNAL(consigneReinitialisee()),capture, SLOT(prendreReferencePhase()));
 
     // Signaux-slots entre les éléments de l'interface
     QObject::connect(guidage,SIGNAL(imageSoleil(QImage)),ui->imageCamera,SLOT(afficherImageSoleil(QImage)));
@@ -0,0 +1,274 @@
+//
+//  fft.c
+//  climso-auto
+//
+//  Transformées de Fourier rapides (Cooley-Tukey radix 2, itératives) pour calculer
+//  la corrélation en O(N log N) au lieu de O(N * points de la référence).
+//
+//  Les complexes sont stockés "entrelacés" : z[2k] = partie réelle, z[2k+1] = partie imaginaire.
+//
+//  Les transformées 2D de tableaux réels n'utilisent que la moitié du spectre (symétrie
+//  hermitienne) : deux lignes réelles a et b sont transformées en une seule FFT complexe
+//  de a + i.b, puis séparées. Les transformées sur les colonnes travaillent sur des
+//  lignes entières à la fois (papillons "vectoriels"), ce qui évite les accès mémoire
+//  espacés d'une ligne entre deux éléments d'une même colonne.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fft.h"
+
+/**
+ * @param n Taille minimale voulue
+ * @return La plus petite puissance de 2 supérieure ou égale à n
+ */
+int fft_taille_optimale(int n) {
+	int taille = 1;
+	while(taille < n)
+		taille <<= 1;
+	return taille;
+}
+
+/**
+ * Prépare les facteurs de rotation et la permutation d'une FFT de taille n
+ * @param n La taille de la transformée, doit être une puissance de 2
+ * @return Le plan, à détruire avec fft_detruire_plan() ; NULL si n n'est pas une puissance de 2
+ */
+PlanFFT* fft_creer_plan(int n) {
+	const double pi = 3.141592653589793238462643383279502884197;
+	PlanFFT *plan;
+	int k, bits, i, j;
+
+	if(n < 1 || (n & (n-1)) != 0)
+		return NULL;
+	plan = (PlanFFT*)malloc(sizeof(PlanFFT));
+	plan->n = n;
+	plan->rotations = (double*)malloc(sizeof(double) * (n > 1 ? n : 2));
+	plan->permutation = (int*)malloc(sizeof(int) * n);
+
+	for(k=0; k < n/2; k++) {
+		plan->rotations[2*k] = cos(2*pi*k/n);
+		plan->rotations[2*k+1] = -sin(2*pi*k/n);
+	}
+	for(bits=0; (1<<bits) < n; bits++);
+	for(i=0; i < n; i++) {
+		for(j=0, k=0; k < bits; k++)
+			j |= ((i >> k) & 1) << (bits-1-k);
+		plan->permutation[i] = j;
+	}
+	return plan;
+}
+
+void fft_detruire_plan(PlanFFT *plan) {
+	if(plan == NULL)
+		return;
+	free(plan->rotations);
+	free(plan->permutation);
+	free(plan);
+}
+
+/**
+ * FFT complexe en place d'un vecteur de plan->n complexes
+ * @param plan
+ * @param z Les complexes entrelacés
+ * @param sens FFT_DIRECTE ou FFT_INVERSE (l'inverse n'est pas divisée par n)
+ */
+void fft_executer(const PlanFFT *plan, double *z, int sens) {
+	int n = plan->n;
+	int i, j, k, longueur, moitie, pas;
+	double tr, ti, wr, wi;
+
+	for(i=0; i < n; i++) {
+		j = plan->permutation[i];
+		if(j > i) {
+			tr = z[2*i]; z[2*i] = z[2*j]; z[2*j] = tr;
+			ti = z[2*i+1]; z[2*i+1] = z[2*j+1]; z[2*j+1] = ti;
+		}
+	}
+	for(longueur=2; longueur <= n; longueur <<= 1) {
+		moitie = longueur/2;
+		pas = n/longueur;
+		for(i=0; i < n; i += longueur) {
+			for(k=0; k < moitie; k++) {
+				double *a = z + 2*(i+k);
+				double *b = z + 2*(i+k+moitie);
+				wr = plan->rotations[2*k*pas];
+				wi = (sens == FFT_DIRECTE) ? plan->rotations[2*k*pas+1] : -plan->rotations[2*k*pas+1];
+				tr = wr*b[0] - wi*b[1];
+				ti = wr*b[1] + wi*b[0];
+				b[0] = a[0] - tr;
+				b[1] = a[1] - ti;
+				a[0] += tr;
+				a[1] += ti;
+			}
+		}
+	}
+}
+
+/**
+ * FFT complexe en place selon les colonnes d'un tableau de plan->n lignes
+ * de "largeur" complexes : chaque papillon s'applique à une ligne entière
+ * @param plan Plan de taille égale au nombre de lignes
+ * @param z Le tableau (lignes les unes à la suite des autres)
+ * @param largeur Nombre de complexes par ligne
+ * @param sens FFT_DIRECTE ou FFT_INVERSE (l'inverse n'est pas divisée par n)
+ */
+void fft_colonnes(const PlanFFT *plan, double *z, int largeur, int sens) {
+	fft_colonnes_partie(plan, z, largeur, 0, largeur, sens);
+}
+
+/**
+ * Comme fft_colonnes, mais seulement sur les colonnes c_debut à c_fin-1 : les colonnes
+ * sont indépendantes, on peut donc répartir les colonnes entre plusieurs threads
+ * (le résultat est le même qu'avec fft_colonnes)
+ */
+void fft_colonnes_partie(const PlanFFT *plan, double *z, int largeur, int c_debut, int c_fin, int sens) {
+	int n = plan->n;
+	int i, j, k, c, longueur, moitie, pas;
+	int taille_ligne = 2*largeur;
+	double tr, ti, wr, wi;
+
+	z += 2*c_debut;
+	largeur = c_fin - c_debut;
+	for(i=0; i < n; i++) {
+		j = plan->permutation[i];
+		if(j > i) {
+			double *li = z + i*taille_ligne, *lj = z + j*taille_ligne;
+			for(c=0; c < 2*largeur; c++) {
+				tr = li[c]; li[c] = lj[c]; lj[c] = tr;
+			}
+		}
+	}
+	for(longueur=2; longueur <= n; longueur <<= 1) {
+		moitie = longueur/2;
+		pas = n/longueur;
+		for(i=0; i < n; i += longueur) {
+			for(k=0; k < moitie; k++) {
+				double *a = z + (i+k)*taille_ligne;
+				double *b = z + (i+k+moitie)*taille_ligne;
+				wr = plan->rotations[2*k*pas];
+				wi = (sens == FFT_DIRECTE) ? plan->rotations[2*k*pas+1] : -plan->rotations[2*k*pas+1];
+				for(c=0; c < 2*largeur; c += 2) {
+					tr = wr*b[c] - wi*b[c+1];
+					ti = wr*b[c+1] + wi*b[c];
+					b[c] = a[c] - tr;
+					b[c+1] = a[c+1] - ti;
+					a[c] += tr;
+					a[c+1] += ti;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Transformée 2D d'un tableau réel, complété par des zéros jusqu'à la taille
+ * P x Q des plans. Seules les Q/2+1 premières colonnes du spectre sont calculées,
+ * les autres s'en déduisent par symétrie hermitienne.
+ */
+void fft_2d_reelle(const PlanFFT *plan_lignes, const PlanFFT *plan_colonnes,
+		const double *src, int hauteur_src, int largeur_src, int pas_src,
+		double *spectre, double *tampon) {
+	fft_2d_reelle_lignes(plan_lignes, plan_colonnes, src, hauteur_src, largeur_src, pas_src,
+			spectre, tampon, 0, plan_lignes->n);
+	fft_colonnes(plan_lignes, spectre, plan_colonnes->n/2 + 1, FFT_DIRECTE);
+}
+
+/**
+ * Première étape de fft_2d_reelle : FFT des lignes l_debut à l_fin-1 du spectre
+ * (l_debut pair, les lignes étant transformées deux par deux). Les blocs de lignes
+ * sont indépendants et peuvent être répartis entre plusieurs threads.
+ */
+void fft_2d_reelle_lignes(const PlanFFT *plan_lignes, const PlanFFT *plan_colonnes,
+		const double *src, int hauteur_src, int largeur_src, int pas_src,
+		double *spectre, double *tampon, int l_debut, int l_fin) {
+	int P = plan_lignes->n, Q = plan_colonnes->n;
+	int M = Q/2 + 1;
+	int l, c, k;
+
+	for(l=l_debut; l < l_fin; l += 2) {
+		double *sp_a = spectre + l*2*M;
+		double *sp_b = spectre + (l+1)*2*M;
+		if(l >= hauteur_src) { // Lignes de zéros
+			memset(sp_a, 0, sizeof(double)*2*M*(l_fin-l));
+			break;
+		}
+		// z = a + i.b avec a la ligne l et b la ligne l+1
+		memset(tampon, 0, sizeof(double)*2*Q);
+		for(c=0; c < largeur_src; c++)
+			tampon[2*c] = src[l*pas_src + c];
+		if(l+1 < hauteur_src) {
+			for(c=0; c < largeur_src; c++)
+				tampon[2*c+1] = src[(l+1)*pas_src + c];
+		}
+		fft_executer(plan_colonnes, tampon, FFT_DIRECTE);
+		// Séparation des deux spectres : A = (Z(k) + conj(Z(Q-k)))/2, B = (Z(k) - conj(Z(Q-k)))/2i
+		for(k=0; k < M; k++) {
+			double zr = tampon[2*k], zi = tampon[2*k+1];
+			double mr = tampon[2*((Q-k)%Q)], mi = tampon[2*((Q-k)%Q)+1];
+			sp_a[2*k] = (zr + mr)/2;
+			sp_a[2*k+1] = (zi - mi)/2;
+			if(l+1 < P) {
+				sp_b[2*k] = (zi + mi)/2;
+				sp_b[2*k+1] = -(zr - mr)/2;
+			}
+		}
+	}
+}
+
+/**
+ * Transformée inverse d'un demi-spectre 2D (produit par fft_2d_reelle) vers un
+ * tableau réel. Seules les lignes et colonnes demandées (prises modulo P et Q,
+ * ce qui permet de lire directement les décalages négatifs d'une corrélation)
+ * sont calculées et écrites dans dst.
+ */
+void fft_2d_reelle_inverse(const PlanFFT *plan_lignes, const PlanFFT *plan_colonnes,
+		double *spectre, double *dst, int l_debut, int hauteur_dst,
+		int c_debut, int largeur_dst, int pas_dst, double *tampon) {
+	fft_colonnes(plan_lignes, spectre, plan_colonnes->n/2 + 1, FFT_INVERSE);
+	fft_2d_reelle_inverse_lignes(plan_lignes, plan_colonnes, spectre, dst, l_debut, hauteur_dst,
+			c_debut, largeur_dst, pas_dst, tampon, 0, hauteur_dst);
+}
+
+/**
+ * Seconde étape de fft_2d_reelle_inverse (après la FFT inverse des colonnes) :
+ * calcule les lignes i_debut à i_fin-1 de dst (i_debut pair). Les blocs de lignes
+ * sont indépendants et peuvent être répartis entre plusieurs threads.
+ */
+void fft_2d_reelle_inverse_lignes(const PlanFFT *plan_lignes, const PlanFFT *plan_colonnes,
+		const double *spectre, double *dst, int l_debut, int hauteur_dst,
+		int c_debut, int largeur_dst, int pas_dst, double *tampon, int i_debut, int i_fin) {
+	int P = plan_lignes->n, Q = plan_colonnes->n;
+	int M = Q/2 + 1;
+	int i, c, k;
+	double echelle = 1.0/((double)P*Q);
+
+	l_debut = ((l_debut % P) + P) % P;
+	c_debut = ((c_debut % Q) + Q) % Q;
+
+	for(i=i_debut; i < i_fin; i += 2) {
+		const double *sp_a = spectre + ((l_debut+i) % P)*2*M;
+		const double *sp_b = (i+1 < hauteur_dst) ? spectre + ((l_debut+i+1) % P)*2*M : NULL;
+		// Z = A + i.B sur toute la ligne, avec X(Q-k) = conj(X(k))
+		for(k=0; k < Q; k++) {
+			double ar, ai, br = 0, bi = 0;
+			if(k < M) {
+				ar = sp_a[2*k]; ai = sp_a[2*k+1];
+				if(sp_b) { br = sp_b[2*k]; bi = sp_b[2*k+1]; }
+			} else {
+				ar = sp_a[2*(Q-k)]; ai = -sp_a[2*(Q-k)+1];
+				if(sp_b) { br = sp_b[2*(Q-k)]; bi = -sp_b[2*(Q-k)+1]; }
+			}
+			tampon[2*k] = ar - bi;
+			tampon[2*k+1] = ai + br;
+		}
+		fft_executer(plan_colonnes, tampon, FFT_INVERSE);
+		for(c=0; c < largeur_dst; c++)
+			dst[i*pas_dst + c] = tampon[2*((c_debut+c) % Q)] * echelle;
+		if(sp_b) {
+			for(c=0; c < largeur_dst; c++)
+				dst[(i+1)*pas_dst + c] = tampon[2*((c_debut+c) % Q)+1] * echelle;
+		}
+	}
+}
@@ -0,0 +1,71 @@
+//
+//  fft.h
+//  climso-auto
+//
+//  Transformées de Fourier rapides (radix 2) utilisées pour la corrélation
+//  dans l'espace des fréquences (voir Image::correlation_fft)
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef climso_auto_fft_h
+#define climso_auto_fft_h
+
+#define FFT_DIRECTE		-1	// sens de la transformée : exp(-2i.pi.k.n/N)
+#define FFT_INVERSE		1	// sens de la transformée inverse (non normalisée)
+
+/**
+ * Plan de calcul d'une FFT de taille n (puissance de 2) : les facteurs de rotation
+ * et la permutation "bit-reversal" sont calculés une fois pour toutes
+ */
+typedef struct {
+	int n;				// taille de la transformée (puissance de 2)
+	double *rotations;	// n/2 facteurs de rotation exp(-2i.pi.k/n), entrelacés (re,im)
+	int *permutation;	// permutation "bit-reversal" des indices
+} PlanFFT;
+
+int fft_taille_optimale(int n);
+PlanFFT* fft_creer_plan(int n);
+void fft_detruire_plan(PlanFFT *plan);
+
+void fft_executer(const PlanFFT *plan, double *z, int sens);
+void fft_colonnes(const PlanFFT *plan, double *z, int largeur, int sens);
+void fft_colonnes_partie(const PlanFFT *plan, double *z, int largeur, int c_debut, int c_fin, int sens);
+
+void fft_2d_reelle(
+	const PlanFFT *plan_lignes,	// plan de taille P (nombre de lignes de la transformée)
+	const PlanFFT *plan_colonnes,	// plan de taille Q (nombre de colonnes de la transformée)
+	const double *src,			// tableau réel source (complété par des zéros jusqu'à P x Q)
+	int hauteur_src,
+	int largeur_src,
+	int pas_src,				// nombre de doubles entre deux lignes de src
+	double *spectre,			// sortie : P lignes de Q/2+1 complexes entrelacés
+	double *tampon);			// tampon de travail de 2*Q doubles
+
+void fft_2d_reelle_inverse(
+	const PlanFFT *plan_lignes,
+	const PlanFFT *plan_colonnes,
+	double *spectre,			// P lignes de Q/2+1 complexes (détruit par le calcul)
+	double *dst,				// sortie réelle, normalisée par 1/(P*Q)
+	int l_debut,				// première ligne (modulo P) à écrire dans dst
+	int hauteur_dst,
+	int c_debut,				// première colonne (modulo Q) à écrire dans dst
+	int largeur_dst,
+	int pas_dst,				// nombre de doubles entre deux lignes de dst
+	double *tampon);			// tampon de travail de 2*Q doubles
+
+// Les deux étapes de chaque transformée 2D, par blocs de lignes (pour le calcul en parallèle)
+void fft_2d_reelle_lignes(const PlanFFT *plan_lignes, const PlanFFT *plan_colonnes,
+	const double *src, int hauteur_src, int largeur_src, int pas_src,
+	double *spectre, double *tampon, int l_debut, int l_fin);
+void fft_2d_reelle_inverse_lignes(const PlanFFT *plan_lignes, const PlanFFT *plan_colonnes,
+	const double *spectre, double *dst, int l_debut, int hauteur_dst,
+	int c_debut, int largeur_dst, int pas_dst, double *tampon, int i_debut, int i_fin);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
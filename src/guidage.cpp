@@ -66,6 +66,7 @@ Guidage::Guidage() {
 	qRegisterMetaType<EtatConsigne>("EtatConsigne");
 	qRegisterMetaType<EtatArduino>("EtatArduino");
 	qRegisterMetaType<EtatGuidage>("EtatGuidage");
+	qRegisterMetaType<NiveauLocalisation>("NiveauLocalisation");
 
 	timerConnexionAuto.setInterval(PERIODE_ENTRE_CONNEXIONS);
 	arduino = NULL;
@@ -194,6 +195,7 @@ void Guidage::consigneReset() {
 				+ QString::number(consigne_l) + ")");
 	etatConsigne = CONSIGNE_OK;
 	afficherImageSoleilEtReperes();
+	emit consigneReinitialisee();
 }
 
 /**
@@ -224,21 +226,31 @@ void Guidage::guider() {
 		stopperGuidage();
 		return;
 	}
-	// Calcul de la moyenne de décalage
-	double moyenne_l = 0, moyenne_c = 0;
-	int i;
-	for (i = 0; i<position_l.length(); i++) {
-		moyenne_l += position_l.last();
-		moyenne_c += position_c.last();
+	while(position_c.length() > 100) {
+		position_c.removeFirst();
+		position_l.removeFirst();
+		position_niveau.removeFirst();
+	}
+	// Dernière position assez précise pour guider (pas un simple centroïde) parmi celles
+	// reçues depuis le dernier guidage
+	int debut = qMax(0, position_l.length() - POSITIONS_PAR_GUIDAGE);
+	int i = position_l.length()-1;
+	while(i >= debut && position_niveau.at(i) != NIVEAU_FIN && position_niveau.at(i) != NIVEAU_GROSSIER) {
+		i--;
+	}
+	if (i < debut) {
+		return; // Aucune position assez précise, on attend les suivantes
 	}
-	moyenne_l = moyenne_l / i;
-	moyenne_c = moyenne_c / i;
 	// Calcul du décalage x,y entre la position initiale
-	double l_decal = moyenne_l - consigne_l;
-	double c_decal = moyenne_c - consigne_c;
+	double l_decal = position_l.at(i) - consigne_l;
+	double c_decal = position_c.at(i) - consigne_c;
 	// Calcul de la longueur en pixels du décalage
 	decalage << qSqrt(l_decal * l_decal + c_decal * c_decal);
 	decalageTimestamp << QTime::currentTime();
+	while(decalage.length() > 100) {
+		decalage.removeFirst();
+		decalageTimestamp.removeFirst();
+	}
 
 	/* Vérification de la divergence (les commandes n'ont pas d'effet/un effet contraire)
 	 * 	Soit D(t) le décalage au temps t). On considère qu'il y a divergence ssi :
@@ -265,23 +277,17 @@ void Guidage::guider() {
 		}
 	}
 
-	while(decalage.length() > 100) {
-		decalage.removeFirst();
-		decalageTimestamp.removeFirst();
-	}
-	while(position_c.length() > 100) {
-		position_c.removeFirst();
-		position_l.removeFirst();
-	}
-
 	emit message(
-			"(x= " + QString::number(position_c.last()) + ", y="
-			+ QString::number(position_l.last()) + ") "
+			"(x= " + QString::number(position_c.at(i)) + ", y="
+			+ QString::number(position_l.at(i)) + ") "
 			", (dx= " + QString::number(l_decal) + ", dy="
 			+ QString::number(c_decal) + ")");
 
-	int l_decal_duree = qAbs(l_decal * gainVertical);
-	int c_decal_duree = qAbs(c_decal * gainHorizontal);
+	// Position grossière (délai de localisation écoulé pendant la pyramide) : impulsions réduites
+	// pour ne pas sur-corriger une erreur de position ; l'historique des décalages reste brut
+	double gain = (position_niveau.at(i) == NIVEAU_GROSSIER) ? GAIN_POSITION_GROSSIERE : 1;
+	int l_decal_duree = qAbs(l_decal * gainVertical * gain);
+	int c_decal_duree = qAbs(c_decal * gainHorizontal * gain);
 
 	// La duree entre deux corrections ne doit pas depasser la limite fixée
 	// dans le micro-code de l'arduino.
@@ -380,13 +386,17 @@ void Guidage::envoyerCmd(int pin, int duree) {
  * @param l
  * @param c
  * @param diametre
- * @param signalBruit
+ * @param signalBruit Rapport pic/lobes de la corrélation : nombre d'écarts types du pic au dessus
+ * des lobes qui l'entourent (2 à 5 sans soleil), ou qualité de la méthode de localisation
+ * @param niveau Précision de la position (Capture s'arrête à une estimation grossière
+ * si le délai de localisation est écoulé)
  */
-void Guidage::traiterResultatsCapture(QImage img, double l, double c, int diametre, double signalbruit) {
+void Guidage::traiterResultatsCapture(QImage img, double l, double c, int diametre, double signalbruit, NiveauLocalisation niveau) {
 	static int cptPositions = 0;
 	this->diametre = diametre;
 	position_l << l;
 	position_c << c;
+	position_niveau << niveau;
 	this->img = QImage(img);
 	this->signalbruit = signalbruit;
 
@@ -20,6 +20,7 @@
 #include <QtGui/QImage>
 #include <QtGui/QColor>
 #include "arduino.h"
+#include "niveau_localisation.h"
 
 /* 	Pour les paramètres: certains paramètres sont à configurer dans le fichier
  * 		~/.config/irap/climso-auto.conf (ou directement depuis menu > paramètres)
@@ -37,6 +38,7 @@
 #define DUREE_IMPULSION_MAX		10000 // en ms
 #define INCREMENT_LENT		0.1 // Vitesse de déplacement de la consigne à chaque déplacement en nombre de pixels
 #define INCREMENT_RAPIDE	1	// Vitesse de déplacement de la consigne à chaque déplacement en nombre de pixels
+#define GAIN_POSITION_GROSSIERE	0.5	// Facteur des durées d'impulsion pour une position NIVEAU_GROSSIER (pic de la pyramide, moins précis)
 //#define SEUIL_DECALAGE_PIXELS		0.05 // Distance en pixels en dessous laquelle la position est estimée comme correcte
 
 
@@ -81,6 +83,7 @@ private:
 	double consigne_l, consigne_c;
 	QImage img;	// Image envoyée par la classe Capture par le signal resultat()
 	QList<double> position_l, position_c; // Historique des positions
+	QList<NiveauLocalisation> position_niveau; // Précision de chaque position (seules NIVEAU_GROSSIER et NIVEAU_FIN guident)
 	double signalbruit;
 	int diametre; // Diametre du soleil en pixels pour l'affichage lorsqu'on utilisera repereSoleil(...)
 
@@ -122,7 +125,7 @@ public slots:
 	void lancerGuidage();
 	void stopperGuidage();
 	void modifierConsigne(int deltaLigne, int deltaColonne, bool decalageLent);
-	void traiterResultatsCapture(QImage img, double l, double c, int diametre,double bruitsignal);
+	void traiterResultatsCapture(QImage img, double l, double c, int diametre,double bruitsignal, NiveauLocalisation niveau);
 	// arduino
 	void connecterArduino(QString nom);
 	void deconnecterArduino();
@@ -147,6 +150,7 @@ signals:
 	void repereCourant(float pourcent_x, float pourcent_y,float diametre_pourcent_x, EtatPosition);
 	void repereConsigne(float pourcent_x, float pourcent_y,float diametre_pourcent_x, EtatConsigne);
 	void signalBruit(double);
+	void consigneReinitialisee(); // Capture prend alors l'image de référence de la corrélation de phase
 };
 
 #endif /* GUIDAGE_H_ */
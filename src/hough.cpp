@@ -0,0 +1,278 @@
+/*
+ * hough.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Le contour (pixels où le gradient de Sobel est fort) est extrait une seule fois,
+ *  puis chaque diamètre est une tâche indépendante avec son propre accumulateur :
+ *  le résultat ne dépend pas du nombre de threads. Les votes sont répartis
+ *  (bilinéairement) sur les 4 pixels autour du centre visé, ce qui permet de
+ *  trouver le centre à mieux qu'un pixel.
+ */
+
+#include "hough.h"
+#include <cmath>
+
+HoughCercle::HoughCercle(ThreadsCalcul* threads) {
+	this->threads = threads;
+	lignes = colonnes = 0;
+	contour_l = contour_c = direction_l = direction_c = NULL;
+	nb_contour = capacite_contour = 0;
+	accumulateurs = touchees = NULL;
+	nb_touchees = NULL;
+	nb_accumulateurs = capacite_touchees = nb_diametres = 0;
+	diametre_min = pas_diametre = 0;
+	scores = NULL;
+	pics_l = pics_c = NULL;
+}
+
+HoughCercle::~HoughCercle() {
+	if(contour_l) delete [] contour_l;
+	if(contour_c) delete [] contour_c;
+	if(direction_l) delete [] direction_l;
+	if(direction_c) delete [] direction_c;
+	for (int k=0; k < nb_accumulateurs; k++) {
+		delete [] accumulateurs[k];
+		delete [] touchees[k];
+	}
+	if(accumulateurs) delete [] accumulateurs;
+	if(touchees) delete [] touchees;
+	if(nb_touchees) delete [] nb_touchees;
+	if(scores) delete [] scores;
+	if(pics_l) delete [] pics_l;
+	if(pics_c) delete [] pics_c;
+}
+
+/**
+ * Extrait les pixels du contour : ceux dont la norme du gradient (Sobel) dépasse
+ * seuil_relatif fois la norme maximale (et au moins 3 fois la norme moyenne, celle du bruit)
+ * @param img L'image capturée (pas sa dérivée : il faut la direction du gradient)
+ * @param seuil_relatif Entre 0 et 1
+ */
+void HoughCercle::extraireContour(Image& img, double seuil_relatif) {
+	const MonDouble *p = img.ptr();
+	int taille = lignes*colonnes;
+	if(capacite_contour < taille) {
+		if(contour_l) delete [] contour_l;
+		if(contour_c) delete [] contour_c;
+		if(direction_l) delete [] direction_l;
+		if(direction_c) delete [] direction_c;
+		contour_l = new double[taille];
+		contour_c = new double[taille];
+		direction_l = new double[taille];
+		direction_c = new double[taille];
+		capacite_contour = taille;
+	}
+	// Premier passage : gradients et norme maximale (gardés dans les tableaux du contour)
+	double norme_max = 0, somme = 0;
+	int n = 0;
+	for (int l=1; l < lignes-1; l++) {
+		for (int c=1; c < colonnes-1; c++) {
+			const MonDouble *q = p + l*colonnes + c;
+			double gl = (q[colonnes-1] + 2*q[colonnes] + q[colonnes+1]) - (q[-colonnes-1] + 2*q[-colonnes] + q[-colonnes+1]);
+			double gc = (q[-colonnes+1] + 2*q[1] + q[colonnes+1]) - (q[-colonnes-1] + 2*q[-1] + q[colonnes-1]);
+			double norme = sqrt(gl*gl + gc*gc);
+			direction_l[n] = gl;
+			direction_c[n] = gc;
+			contour_l[n] = norme;
+			norme_max = max(norme_max, norme);
+			somme += norme;
+			n++;
+		}
+	}
+	double seuil = max(seuil_relatif * norme_max, 3 * somme/max(n, 1));
+	// Second passage : on ne garde que les pixels au dessus du seuil (n croît moins vite que i)
+	nb_contour = 0;
+	for (int l=1, i=0; l < lignes-1; l++) {
+		for (int c=1; c < colonnes-1; c++, i++) {
+			double norme = contour_l[i];
+			if(norme > seuil) {
+				direction_l[nb_contour] = direction_l[i] / norme;
+				direction_c[nb_contour] = direction_c[i] / norme;
+				contour_l[nb_contour] = l;
+				contour_c[nb_contour] = c;
+				nb_contour++;
+			}
+		}
+	}
+}
+
+/**
+ * Remet à zéro les cases touchées par les votes précédents du diamètre d'indice "indice"
+ */
+void HoughCercle::effacerVotes(int indice) {
+	int *a = accumulateurs[indice];
+	for (int k=0; k < nb_touchees[indice]; k++) {
+		int *v = a + touchees[indice][k];
+		v[0] = v[1] = v[colonnes] = v[colonnes+1] = 0;
+	}
+	nb_touchees[indice] = 0;
+}
+
+/**
+ * Votes de tous les pixels du contour pour le diamètre d'indice "indice", puis
+ * recherche du pic de l'accumulateur parmi les cases qui ont reçu des votes. Le score
+ * est le nombre de votes autour du pic (3x3 pixels) par pixel de circonférence, pour
+ * comparer les diamètres entre eux.
+ * L'accumulateur doit être à zéro (effacerVotes())
+ */
+void HoughCercle::voter(int indice) {
+	int *a = accumulateurs[indice];
+	int *t = touchees[indice];
+	int n = 0;
+	double rayon = (diametre_min + indice*pas_diametre) / 2;
+	for (int k=0; k < nb_contour; k++) {
+		double l = contour_l[k] + rayon*direction_l[k];
+		double c = contour_c[k] + rayon*direction_c[k];
+		int l0 = (int)floor(l), c0 = (int)floor(c);
+		if(l0 < 0 || c0 < 0 || l0 >= lignes-1 || c0 >= colonnes-1) {
+			continue;
+		}
+		int fl = (int)((l - l0)*POIDS_VOTE + 0.5), fc = (int)((c - c0)*POIDS_VOTE + 0.5);
+		int part = fl*fc / POIDS_VOTE; // les 4 parts font exactement POIDS_VOTE
+		int *v = a + l0*colonnes + c0;
+		v[0] += POIDS_VOTE - fl - fc + part;
+		v[1] += fc - part;
+		v[colonnes] += fl - part;
+		v[colonnes+1] += part;
+		t[n++] = l0*colonnes + c0;
+	}
+	nb_touchees[indice] = n;
+	// Le pic est centré sur une des 4 cases d'un vote (à distance du bord pour la somme 3x3)
+	int l_max = 1, c_max = 1, somme_max = -1;
+	for (int k=0; k < n; k++) {
+		for (int coin=0; coin < 4; coin++) {
+			int i = t[k] + (coin >> 1)*colonnes + (coin & 1);
+			int l = i / colonnes, c = i - l*colonnes;
+			if(a[i] * 9 <= somme_max || l < 1 || c < 1 || l >= lignes-1 || c >= colonnes-1) {
+				continue; // le pixel central ne peut pas battre le maximum actuel
+			}
+			int somme = 0;
+			for (int dl=-1; dl <= 1; dl++) {
+				for (int dc=-1; dc <= 1; dc++) {
+					somme += a[i + dl*colonnes + dc];
+				}
+			}
+			if(somme > somme_max) {
+				somme_max = somme;
+				l_max = l;
+				c_max = c;
+			}
+		}
+	}
+	pics_l[indice] = l_max;
+	pics_c[indice] = c_max;
+	scores[indice] = max(somme_max, 0) / (double)POIDS_VOTE / (M_PI * (diametre_min + indice*pas_diametre));
+}
+
+void HoughCercle::tacheDiametre(void* contexte, int indice, int /* num_thread */) {
+	((HoughCercle*)contexte)->voter(indice);
+}
+
+/**
+ * Sommet de la parabole passant par (-1,a), (0,b), (1,c), entre -0.5 et 0.5
+ */
+static double sommetParabole(double a, double b, double c) {
+	double d = a - 2*b + c;
+	if(d >= 0) {
+		return 0;
+	}
+	return max(-0.5, min(0.5, (a - c) / (2*d)));
+}
+
+/**
+ * Cherche le cercle du soleil parmi les diamètres diametre_min, diametre_min+pas... diametre_max
+ * @param img L'image capturée
+ * @param diametre_min
+ * @param diametre_max
+ * @param pas_diametre
+ * @param l Centre trouvé
+ * @param c
+ * @param diametre Diamètre trouvé (interpolé entre les diamètres essayés)
+ * @param score Votes par pixel de circonférence (0 à 1 environ pour un contour de 1px
+ * d'épaisseur, plus pour un limbe flou) : voir voter()
+ * @return false s'il n'y a aucun contour
+ */
+bool HoughCercle::chercher(Image& img, double diametre_min, double diametre_max, double pas_diametre,
+		double *l, double *c, double *diametre, double *score) {
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	int n = max(1, (int)floor((diametre_max - diametre_min) / pas_diametre) + 1);
+	if(img.getLignes() != lignes || img.getColonnes() != colonnes || n > nb_accumulateurs) {
+		for (int k=0; k < nb_accumulateurs; k++) {
+			delete [] accumulateurs[k];
+			delete [] touchees[k];
+		}
+		if(accumulateurs) delete [] accumulateurs;
+		if(touchees) delete [] touchees;
+		if(nb_touchees) delete [] nb_touchees;
+		if(scores) delete [] scores;
+		if(pics_l) delete [] pics_l;
+		if(pics_c) delete [] pics_c;
+		lignes = img.getLignes();
+		colonnes = img.getColonnes();
+		nb_accumulateurs = n;
+		capacite_touchees = 0;
+		accumulateurs = new int*[n];
+		touchees = new int*[n];
+		nb_touchees = new int[n];
+		for (int k=0; k < n; k++) {
+			accumulateurs[k] = new int[lignes*colonnes]();
+			touchees[k] = NULL;
+			nb_touchees[k] = 0;
+		}
+		scores = new double[n];
+		pics_l = new int[n];
+		pics_c = new int[n];
+	}
+	this->diametre_min = diametre_min;
+	this->pas_diametre = pas_diametre;
+	nb_diametres = n;
+	if(lignes < 3 || colonnes < 3) {
+		return false;
+	}
+	// Les accumulateurs sont remis à zéro là où la recherche précédente a voté
+	for (int k=0; k < nb_accumulateurs; k++) {
+		effacerVotes(k);
+	}
+	extraireContour(img, 0.3);
+	if(nb_contour == 0) {
+		return false;
+	}
+	if(capacite_touchees < nb_contour) {
+		for (int k=0; k < nb_accumulateurs; k++) {
+			if(touchees[k]) delete [] touchees[k];
+			touchees[k] = new int[nb_contour];
+		}
+		capacite_touchees = nb_contour;
+	}
+	if(threads) {
+		threads->executer(tacheDiametre, this, nb_diametres);
+	} else {
+		for (int k=0; k < nb_diametres; k++) {
+			voter(k);
+		}
+	}
+	int meilleur = 0;
+	for (int k=1; k < nb_diametres; k++) {
+		if(scores[k] > scores[meilleur]) {
+			meilleur = k;
+		}
+	}
+	// Affinage : paraboles autour du pic (centre) et autour du meilleur score (diamètre)
+	const int* acc = accumulateurs[meilleur] + pics_l[meilleur]*colonnes + pics_c[meilleur];
+	*l = pics_l[meilleur] + sommetParabole(acc[-colonnes], acc[0], acc[colonnes]);
+	*c = pics_c[meilleur] + sommetParabole(acc[-1], acc[0], acc[1]);
+	double decalage = 0;
+	if(meilleur > 0 && meilleur < nb_diametres-1) {
+		decalage = sommetParabole(scores[meilleur-1], scores[meilleur], scores[meilleur+1]);
+	}
+	*diametre = diametre_min + (meilleur + decalage)*pas_diametre;
+	*score = scores[meilleur];
+#if DEBUG
+	printf ("Temps Hough (%d diametres, %d points de contour) = %4.3f s\n", nb_diametres, nb_contour,
+			(double)(clock() - temps_calcul) /CLOCKS_PER_SEC);
+#endif
+	return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * hough.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Transformée de Hough pour les cercles : recherche du centre ET du diamètre du
+ *  soleil en un seul passage sur les pixels du contour, sans corrélation.
+ *  Chaque pixel du contour vote, pour chaque diamètre essayé, pour un seul centre :
+ *  celui situé à un rayon dans la direction de son gradient (le soleil est plus
+ *  lumineux que le fond, le gradient pointe vers le centre).
+ */
+
+#ifndef HOUGH_H_
+#define HOUGH_H_
+
+#include "image.h"
+#include "threads_calcul.h"
+
+#define POIDS_VOTE	256		// un vote est réparti en POIDS_VOTE parts entières sur 4 pixels
+
+class HoughCercle {
+private:
+	ThreadsCalcul* threads; // Peut être NULL
+	int lignes, colonnes;
+	// Pixels du contour : position et direction (unitaire) du gradient
+	double *contour_l, *contour_c, *direction_l, *direction_c;
+	int nb_contour, capacite_contour;
+	// Un accumulateur et un résultat par diamètre essayé (une tâche par diamètre). Les votes
+	// sont entiers (POIDS_VOTE par vote) ; les cases touchées sont notées pour ne chercher le
+	// pic que là et pour remettre l'accumulateur à zéro sans le parcourir en entier.
+	int** accumulateurs;
+	int** touchees;		// indice de la case en haut à gauche des 4 cases de chaque vote
+	int* nb_touchees;
+	int nb_accumulateurs, capacite_touchees;
+	int nb_diametres;
+	double diametre_min, pas_diametre;
+	double *scores;
+	int *pics_l, *pics_c;
+
+	void extraireContour(Image& img, double seuil_relatif);
+	void effacerVotes(int indice);
+	void voter(int indice);
+	static void tacheDiametre(void* contexte, int indice, int num_thread);
+public:
+	HoughCercle(ThreadsCalcul* threads=NULL);
+	~HoughCercle();
+	bool chercher(Image& img, double diametre_min, double diametre_max, double pas_diametre,
+			double *l, double *c, double *diametre, double *score);
+	int getNombrePointsContour() { return nb_contour; }
+};
+
+#endif /* HOUGH_H_ */
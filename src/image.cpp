@@ -429,10 +429,7 @@ Image* Image::correlation_simple(Image& reference, float seuil_ref) {
  */
 Image* Image::correlation_rapide(Image& reference, float seuil_ref) {
 	Image* obj = this;
-	Image* ref = new Image(reference);
-    
-	ref->normaliser(); // normalisation pour le seuil
-	MonDouble seuil_relatif = seuil_ref*INTENSITE_MAX;
+	Image* ref = reference.referenceSeuillee(seuil_ref);
     
     Image *convol = new Image(obj->getLignes()+ref->getLignes()-1, obj->getColonnes()+ref->getColonnes()-1);
 	convol->init(0);
@@ -448,7 +445,7 @@ Image* Image::correlation_rapide(Image& reference, float seuil_ref) {
 	for (int l_ref=0; l_ref < ref->lignes; l_ref++) {
 		for (int c_ref=0; c_ref < ref->colonnes; c_ref++) {
             int ref_pix = ref->getPix(l_ref,c_ref);
-			if(ref_pix > seuil_relatif) {
+			if(ref_pix > 0) { // au dessus du seuil
 				// On calcule quels point de "convol" correspondent à des décalages
 				// valides (c'est à dire provoquant une intersection entre "ref" et "obj") ;
 				// Un décalage est un vecteur (l_decal, c_decal) équivalent à (l_convol,c_convol)
@@ -492,6 +489,27 @@ Image* Image::correlation_rapide(Image& reference, float seuil_ref) {
 	return convol;
 }
 
+/**
+ * Référence normalisée puis seuillée : les poids de toutes les corrélations avec seuil
+ * (correlation_rapide, correlation_fft, Correlateur et les localisateurs qui en dérivent).
+ * La valeur du pixel normalisé est tronquée en int, comme dans la première version de
+ * correlation_rapide.
+ * @param seuil_ref Le seuil minimal de prise en compte des valeurs des pixels, entre 0 et 1
+ * @return Une nouvelle image (à supprimer par l'appelant), nulle sous le seuil
+ */
+Image* Image::referenceSeuillee(float seuil_ref) {
+	Image* ref = new Image(*this);
+	ref->normaliser(); // normalisation pour le seuil
+	MonDouble seuil_relatif = seuil_ref*INTENSITE_MAX;
+	for (int l=0; l < ref->lignes; l++) {
+		for (int c=0; c < ref->colonnes; c++) {
+			int ref_pix = ref->getPix(l,c);
+			ref->setPix(l, c, (ref_pix > seuil_relatif) ? ref_pix : 0);
+		}
+	}
+	return ref;
+}
+
 /**
  * Correl où l'espace de correl est limité à l'image "obj", donc on n'étudie pas
  * les cas de décalage où la référence n'est pas incluse dans l'objet
@@ -504,11 +522,84 @@ Image* Image::correlation_rapide_centree(Image& reference, float seuil_ref) {
 	Image* img = correlation_rapide(reference,seuil_ref);
 	// FIXME: L'image "découpée" est environ 1 à 2 pixels en dessous de l'image qu'on devrait avoir (comparaison avec algo LK)
 	Image* img_centree = new Image(*img,reference.lignes/2,reference.colonnes/2,img->lignes-(reference.lignes-1),img->colonnes - (reference.colonnes-1));
+#if DEBUG
 	img_centree->versTiff("t_obj_centre.tif");
+#endif
 	delete img;
 	return img_centree;
 }
 
+#if INCLUDE_FFT
+/**
+ * Correlation de l'image receveuse avec l'image référence calculée dans l'espace
+ * des fréquences : convol = TF-1( TF(obj) x conj(TF(ref)) ), en O(N log N) au lieu
+ * de O(N x nombre de points de ref au dessus du seuil) pour correlation_rapide.
+ * Le résultat est le même espace de corrélation que correlation_rapide (à l'arrondi près),
+ * qui reste la fonction de référence pour vérifier les résultats.
+ * Les images sont complétées par des zéros jusqu'à des tailles puissances de 2
+ * supérieures à celle de l'espace de corrélation pour éviter le recouvrement circulaire.
+ * @param reference L'image de référence
+ * @param seuil_ref Le seuil minimal de prise en compte des valeurs des pixles de la référence, entre 0 et 1
+ * @return L'espace de corrélation, de taille (lignes+ref.lignes-1) x (colonnes+ref.colonnes-1)
+ */
+Image* Image::correlation_fft(Image& reference, float seuil_ref) {
+	Image* obj = this;
+	Image* ref = reference.referenceSeuillee(seuil_ref); // Mêmes poids que correlation_rapide
+
+	int haut_convol = obj->lignes+ref->lignes-1;
+	int larg_convol = obj->colonnes+ref->colonnes-1;
+	PlanFFT* plan_lignes = fft_creer_plan(fft_taille_optimale(haut_convol));
+	PlanFFT* plan_colonnes = fft_creer_plan(fft_taille_optimale(max(larg_convol,2)));
+	int P = plan_lignes->n, M = plan_colonnes->n/2+1;
+	double* spectre_obj = new double[P*2*M];
+	double* spectre_ref = new double[P*2*M];
+	double* tampon = new double[2*plan_colonnes->n];
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+
+	fft_2d_reelle(plan_lignes, plan_colonnes, obj->img, obj->lignes, obj->colonnes, obj->colonnes, spectre_obj, tampon);
+	fft_2d_reelle(plan_lignes, plan_colonnes, ref->img, ref->lignes, ref->colonnes, ref->colonnes, spectre_ref, tampon);
+	// Produit TF(obj) x conj(TF(ref)) : corrélation et non convolution
+	for (int k=0; k < P*M; k++) {
+		double o_re = spectre_obj[2*k], o_im = spectre_obj[2*k+1];
+		double r_re = spectre_ref[2*k], r_im = spectre_ref[2*k+1];
+		spectre_obj[2*k] = o_re*r_re + o_im*r_im;
+		spectre_obj[2*k+1] = o_im*r_re - o_re*r_im;
+	}
+	// Le point (l_convol,c_convol) de convol correspond au décalage (l_convol-(ref->lignes-1), ...)
+	// entre ref(0,0) et obj(0,0) (cf correlation_rapide) ; les décalages négatifs sont lus modulo P et Q
+	Image *convol = new Image(haut_convol, larg_convol);
+	fft_2d_reelle_inverse(plan_lignes, plan_colonnes, spectre_obj, convol->img,
+			-(ref->lignes-1), haut_convol, -(ref->colonnes-1), larg_convol, convol->colonnes, tampon);
+#if DEBUG
+	printf ("Temps calcul FFT = %4.2f s (%dx%d)\n",  (double)(clock() - temps_calcul) /CLOCKS_PER_SEC, P, plan_colonnes->n);
+#endif
+
+	delete [] spectre_obj;
+	delete [] spectre_ref;
+	delete [] tampon;
+	fft_detruire_plan(plan_lignes);
+	fft_detruire_plan(plan_colonnes);
+	delete ref;
+	convol->normaliser();
+	return convol;
+}
+
+/**
+ * Equivalent de correlation_rapide_centree utilisant correlation_fft
+ * @param reference L'image de référence
+ * @param seuil_ref Le seuil minimal de prise en compte des valeurs des pixles de la référence, entre 0 et 1
+ * @return L'espace de corrélation, de la taille de l'image receveuse
+ */
+Image* Image::correlation_fft_centree(Image& reference, float seuil_ref) {
+	Image* img = correlation_fft(reference,seuil_ref);
+	Image* img_centree = new Image(*img,reference.lignes/2,reference.colonnes/2,img->lignes-(reference.lignes-1),img->colonnes - (reference.colonnes-1));
+	delete img;
+	return img_centree;
+}
+#endif
+
 #if INCLUDE_CONVOL
 /**
  * Corrélation (de convol.c)
@@ -581,6 +672,25 @@ void Image::normaliser(MonDouble minSortie, MonDouble maxSortie) {
     }
 }
 
+/**
+ * Multiplie toutes les valeurs de l'image par un coefficient
+ * @param coef Coefficient positif (les positions min et max restent les mêmes)
+ */
+void Image::multiplier(MonDouble coef) {
+	MonDouble* pt = img;
+	for (int i=0; i < lignes*colonnes; i++) {
+		pt[i] *= coef;
+	}
+}
+
+/**
+ * Oublie les min et max déjà trouvés ; à appeler quand les pixels ont été
+ * modifiés directement (par ptr()) dans une image réutilisée
+ */
+void Image::reinitialiserMinMax() {
+	max_c = max_l = min_c = min_l = -1;
+}
+
 /**
  * Détermine les min et max en interne, si valMax, valMin,
  * posMax* ou posMin* demandé
@@ -615,9 +725,20 @@ bool Image::determinerMinMax() {
  */
 Image* Image::reduire(int binning) {
     Image *img_dst = new Image(lignes/binning, colonnes/binning);
+    reduire(binning, *img_dst);
+    return img_dst;
+}
+
+/**
+ * Comme reduire(binning) mais en écrivant le résultat dans une image existante,
+ * de taille (lignes/binning) x (colonnes/binning)
+ * @param binning La taille du carré de binning
+ * @param img_dst L'image réduite
+ */
+void Image::reduire(int binning, Image& img_dst) {
     // On parcourt l'image de destination qui reçoit le bining (img_dst)
-    for (int l_dst = 0 ; l_dst< img_dst->lignes ; l_dst++) {
-        for (int c_dst = 0 ; c_dst< img_dst->colonnes ; c_dst++) {
+    for (int l_dst = 0 ; l_dst< img_dst.lignes ; l_dst++) {
+        for (int c_dst = 0 ; c_dst< img_dst.colonnes ; c_dst++) {
             int l_src = l_dst * binning;
             int c_src = c_dst * binning;
             MonDouble somme = 0;
@@ -627,10 +748,10 @@ Image* Image::reduire(int binning) {
                     somme += this->getPix(l_tab_moy, c_tab_moy);
                 }
             }
-            img_dst->setPix(l_dst, c_dst, somme / (binning*binning));
+            img_dst.setPix(l_dst, c_dst, somme / (binning*binning));
         }
     }
-    return img_dst;
+    img_dst.reinitialiserMinMax();
 }
 
 /**
@@ -761,25 +882,30 @@ Image* Image::interpolerAutourDeCePoint(int l, int c, float pas_interp, float ta
 	Image* interp = new Image(marge_interp,marge_interp);
 	interp->init(0);
 	
-	// Création du tableau temporaire contenant l'objet receveur
-	double** source = this->versTableauDeDouble();
+	// Zone lue (ROI) : le carré plus les 4x4 points autour de chaque point interpolé. Elle n'est
+	// coupée qu'aux bords de l'image, où la zone d'interpolation est décalée comme sur l'image
+	// entière : même résultat qu'avec une copie complète en double**, sans la copie
+	int l_deb = max(0, (int)floor(l - taille/2) - 1), l_fin = min(lignes, (int)floor(l + taille/2) + 3);
+	int c_deb = max(0, (int)floor(c - taille/2) - 1), c_fin = min(colonnes, (int)floor(c + taille/2) + 3);
+	if(l_fin - l_deb < 4 || c_fin - c_deb < 4) {
+		l_deb = c_deb = 0;
+		l_fin = lignes;
+		c_fin = colonnes;
+	}
+	const MonDouble* zone = ptr() + l_deb*colonnes + c_deb;
 
-	// Interpolation point par point en utilisant le tableau temporaire
+	// Interpolation point par point directement dans le buffer de l'image
 	for (int l_interp = 0; l_interp < marge_interp; l_interp++) {
 		for (int c_interp = 0; c_interp < marge_interp; c_interp++) {
 			if(l_interp < this->getLignes() && c_interp < this->getColonnes()) {
 				double l_correl = l_interp*pas_interp + l - taille/2;
 				double c_correl = c_interp*pas_interp + c - taille/2;
 				interp->setPix(l_interp, c_interp,
-					it_pol_neville2D_s4(this->getLignes(), this->getColonnes(), source,
-										l_correl, c_correl));
+					it_pol_neville2D_s4_pas(l_fin - l_deb, c_fin - c_deb, zone, colonnes,
+										l_correl - l_deb, c_correl - c_deb));
 			}
 		}
 	}
-	// Suppression du tableau temporaire
-	for(int l=0; l<this->lignes; l++)
-		delete [] source[l];
-	delete [] source;
     return interp;
 }
 /**
@@ -855,6 +981,164 @@ double Image::calculerSignalSurBruit(int l_point, int c_point) {
 }
 
 
+/**
+ * Rapport pic/lobes (PSR) d'un pic : (pic - moyenne des lobes) / écart type des lobes.
+ * Les lobes sont le carré de +/- demi_lobes px autour du pic (coupé aux bords de l'image)
+ * sans le carré de +/- demi_exclusion px. Contrairement au pic / moyenne (calculerSignalSurBruit),
+ * il ne dépend ni de la normalisation de l'image ni de son niveau moyen : c'est un nombre
+ * d'écarts types, proche de 2 à 3 quand il n'y a pas de soleil. Un seul passage sur le carré.
+ * @param l Coordonnées du pic
+ * @param c
+ * @param demi_lobes En px, voir Correlateur::taillesLobes
+ * @param demi_exclusion
+ * @return Le rapport, ou 0 si les lobes sont vides ou constants
+ */
+double Image::rapportPicLobes(int l_point, int c_point, int demi_lobes, int demi_exclusion) {
+	if(l_point < 0 || l_point >= lignes || c_point < 0 || c_point >= colonnes) {
+		return 0;
+	}
+	int l_deb = max(0, l_point - demi_lobes), l_fin = min(lignes, l_point + demi_lobes + 1);
+	int c_deb = max(0, c_point - demi_lobes), c_fin = min(colonnes, c_point + demi_lobes + 1);
+	double somme = 0, somme_carres = 0;
+	int n = 0;
+	for(int l=l_deb; l<l_fin; l++) {
+		const MonDouble *ligne = ptr() + l*colonnes;
+		bool dans_pic = abs(l - l_point) <= demi_exclusion;
+		for(int c=c_deb; c<c_fin; c++) {
+			if(dans_pic && abs(c - c_point) <= demi_exclusion) {
+				continue;
+			}
+			somme += ligne[c];
+			somme_carres += ligne[c]*ligne[c];
+			n++;
+		}
+	}
+	if(n < 2) {
+		return 0;
+	}
+	double moyenne = somme/n, variance = somme_carres/n - moyenne*moyenne;
+	if(variance <= 0) {
+		return 0;
+	}
+	return (getPix(l_point,c_point) - moyenne) / sqrt(variance);
+}
+
+
+/**
+ * Position sous-pixel d'un pic de la dérivée le long d'une ligne ou d'une colonne :
+ * on part du premier point au dessus du seuil, on monte jusqu'au maximum local
+ * puis on ajuste une parabole sur les trois points autour du maximum
+ * @param v Premier élément de la ligne (ou colonne)
+ * @param pas Écart entre deux éléments (1 pour une ligne, colonnes pour une colonne)
+ * @param n Nombre d'éléments
+ * @param i Indice du premier point au dessus du seuil
+ * @param sens +1 si on parcourt vers les indices croissants, -1 sinon
+ */
+static double picSousPixel(const MonDouble *v, int pas, int n, int i, int sens) {
+	while(i+sens >= 0 && i+sens < n && v[(i+sens)*pas] > v[i*pas]) {
+		i += sens;
+	}
+	if(i <= 0 || i >= n-1) {
+		return i;
+	}
+	double g = v[(i-1)*pas], m = v[i*pas], d = v[(i+1)*pas];
+	double denominateur = g - 2*m + d;
+	return (denominateur < 0) ? i + 0.5*(g - d)/denominateur : i;
+}
+
+/**
+ * Extraction de points du limbe dans une image dérivée (convoluerParDerivee) : sur une
+ * ligne (ou colonne) sur "pas", le premier et le dernier pixel au dessus du seuil sont les
+ * bords du disque. Un point n'est gardé que si le limbe y coupe la ligne (ou la colonne)
+ * franchement : la crête de la dérivée doit être plus haute perpendiculairement au
+ * parcours que le long du parcours (sinon le limbe est presque tangent et le point imprécis).
+ * Le seuil est au moins 3 fois la moyenne de l'image, qui est celle du bruit du fond de ciel.
+ * La dérivée au pixel i étant calculée avec le pixel i-1, le bord est en i-0.5.
+ * @param seuil_relatif Seuil entre 0 et 1, en fraction du maximum de l'image
+ * @param pas Écart entre deux lignes (ou colonnes) parcourues
+ * @param l Coordonnées des points trouvés (tableaux de nb_max éléments)
+ * @param c
+ * @param nb_max
+ * @return Le nombre de points trouvés
+ */
+int Image::extrairePointsLimbe(double seuil_relatif, int pas, double *l, double *c, int nb_max) {
+	const int ecart = 3; // pour comparer la crête le long et en travers du parcours
+	double somme = 0;
+	for (int i=0; i < lignes*colonnes; i++) {
+		somme += img[i];
+	}
+	MonDouble seuil = max(seuil_relatif * valeurMax(), 3 * somme/(lignes*colonnes));
+	int n = 0;
+	for (int sens_parcours = 0; sens_parcours < 2; sens_parcours++) {
+		// 0 : parcours des lignes, 1 : parcours des colonnes
+		int nb_parcours = (sens_parcours == 0) ? lignes : colonnes;
+		int longueur = (sens_parcours == 0) ? colonnes : lignes;
+		int pas_v = (sens_parcours == 0) ? 1 : colonnes; // écart entre deux éléments parcourus
+		int pas_travers = (sens_parcours == 0) ? colonnes : 1; // écart d'un parcours au suivant
+		for (int k = ecart; k < nb_parcours-ecart && n+2 <= nb_max; k += pas) {
+			const MonDouble *v = img + k*pas_travers;
+			int debut = 0, fin = longueur-1;
+			while(debut < longueur && v[debut*pas_v] <= seuil) debut++;
+			if(debut >= longueur) {
+				continue;
+			}
+			while(v[fin*pas_v] <= seuil) fin--;
+			int bords[2] = {debut, fin};
+			for (int b = 0; b < 2; b++) {
+				double pos = picSousPixel(v, pas_v, longueur, bords[b], (b == 0) ? 1 : -1);
+				int i = (int)(pos + 0.5);
+				if(i < ecart || i >= longueur-ecart) {
+					continue;
+				}
+				MonDouble le_long = v[(i-ecart)*pas_v] + v[(i+ecart)*pas_v];
+				MonDouble en_travers = v[i*pas_v - ecart*pas_travers] + v[i*pas_v + ecart*pas_travers];
+				if(en_travers <= le_long) {
+					continue;
+				}
+				l[n] = ((sens_parcours == 0) ? k : pos) - 0.5;
+				c[n] = ((sens_parcours == 0) ? pos : k) - 0.5;
+				n++;
+				if(fin == debut) break; // un seul pixel au dessus du seuil
+			}
+		}
+	}
+	return n;
+}
+
+/**
+ * Centre de gravité des pixels au dessus du seuil (moments d'ordre 0 et 1 de l'intensité
+ * moins le seuil), en un seul passage sur l'image capturée. Donne le centre du disque à
+ * quelques pixels près (plus si le disque est coupé par un bord de l'image ou un nuage) :
+ * sert de point de départ à la recherche, pas de position pour le guidage.
+ * @param seuil_relatif Seuil entre 0 et 1, entre le minimum (fond du ciel) et le maximum de l'image
+ * @param l Centre de gravité trouvé
+ * @param c
+ * @return false s'il n'y a aucun pixel au dessus du seuil
+ */
+bool Image::calculerCentroide(double seuil_relatif, double *l, double *c) {
+	MonDouble seuil = valeurMin() + seuil_relatif * (valeurMax() - valeurMin());
+	double somme = 0, somme_l = 0, somme_c = 0;
+	for (int i=0; i < lignes; i++) {
+		// Boucle sans branchement (le poids est nul sous le seuil) : vectorisée par le compilateur
+		const MonDouble *ligne = img + i*colonnes;
+		double somme_ligne = 0, somme_ligne_c = 0;
+		for (int j=0; j < colonnes; j++) {
+			double poids = max(ligne[j] - seuil, 0.0);
+			somme_ligne += poids;
+			somme_ligne_c += poids * j;
+		}
+		somme += somme_ligne;
+		somme_l += somme_ligne * i;
+		somme_c += somme_ligne_c;
+	}
+	if(somme <= 0) {
+		return false;
+	}
+	*l = somme_l / somme;
+	*c = somme_c / somme;
+	return true;
+}
+
 	/**
 	 * Calcul la somme de : (valeur absolue de dérivée partielle en x + val.abs.deriv.partielle en y)
 	 * d'un tableau 2D scalaire : |df/dx| + |df/dy|
@@ -865,17 +1149,32 @@ double Image::calculerSignalSurBruit(int l_point, int c_point) {
 	 * @param size_y
 	 */
 Image* Image::convoluerParDerivee() {
-	Image* img = new Image(*this);
-	img->init(0);
+	Image* img = new Image(lignes, colonnes);
+	convoluerParDerivee(*img);
+	return img;
+}
+
+/**
+ * Comme convoluerParDerivee() mais en écrivant le résultat dans une image existante
+ * (de même taille que l'image receveuse), pour éviter une allocation à chaque image capturée
+ * @param dst L'image résultat
+ */
+void Image::convoluerParDerivee(Image& dst) {
 	double calcul;
+	for (int c=0 ; c < colonnes ; c++) {
+		dst.setPix(0,c,0);
+		dst.setPix(lignes-1,c,0);
+	}
 	for (int l=1 ; l < lignes-1 ; l++) {
+		dst.setPix(l,0,0);
+		dst.setPix(l,colonnes-1,0);
 		for (int c=1 ; c < colonnes-1 ; c++) {
 			calcul = sqrt((getPix(l,c)-getPix(l-1,c))*(getPix(l,c) - getPix(l-1,c))
 					+ (getPix(l,c)-getPix(l,c-1))* (getPix(l,c)-getPix(l,c-1)));
-			img->setPix(l,c,calcul);
+			dst.setPix(l,c,calcul);
 		}
 	}
-	return img;
+	dst.reinitialiserMinMax();
 }
 
 MonDouble Image::valeurMin() {
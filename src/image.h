@@ -10,6 +10,7 @@
 
 // Quelles fonctions externes sont utilisée ?
 #define INCLUDE_INTERPOL	1	// Fonctions contenues dans interpol.c (maxParInterpolation()...)
+#define INCLUDE_FFT			1	// Fonctions contenues dans fft.c (correlation_fft()...)
 #define INCLUDE_CONVOL		0   // Fonction de calcul de correlation données par Laurent Koechlin
 #define INCLUDE_TIFF		1 	// Si 1, alors -L/usr/local/lib et -ltiff
 #define INCLUDE_SBIGCAM		1
@@ -36,6 +37,9 @@ using namespace std;
 #if INCLUDE_CONVOL
 	#include "convol.h"
 #endif
+#if INCLUDE_FFT
+	#include "fft.h"
+#endif
 
 #define NOMBRE_BITS_PAR_SAMPLE		16 // Taille arbitraire (uint16_t)
 #define NOMBRE_SAMPLES_PAR_PIXEL	1  // Car c'est des niveaux de gris
@@ -67,7 +71,10 @@ public:
     void init(int val);
     void normaliser();
     void normaliser(MonDouble minSortie, MonDouble maxSortie);
+    void multiplier(MonDouble coef);
+    void reinitialiserMinMax();
     Image* reduire(int facteur_binning);
+    void reduire(int facteur_binning, Image& dst);
     MonDouble valeurMin();
     MonDouble valeurMax();
     int posMinLigne();
@@ -78,13 +85,22 @@ public:
     static Image* tracerFormeSoleil(int diametre);
 
     // Correlations ecrites par Mael Valais (pour apprendre..)
+    Image* referenceSeuillee(float seuil_ref);
     Image* correlation_simple(Image& p, float seuil_ref);
     Image* correlation_rapide(Image& reference, float seuil_ref); // Correlation optimisée
     Image* correlation_rapide_centree(Image& reference, float seuil_ref); // Correlation optimisée
+#if INCLUDE_FFT
+    Image* correlation_fft(Image& reference, float seuil_ref); // Même résultat que correlation_rapide en O(N log N)
+    Image* correlation_fft_centree(Image& reference, float seuil_ref);
+#endif
     Image* convoluer(const int *noyau, int taille);
     Image* convoluerParDerivee();
+    void convoluerParDerivee(Image& dst);
     Image* deriveeCarre();
     double calculerSignalSurBruit(int l, int c);
+    double rapportPicLobes(int l, int c, int demi_lobes, int demi_exclusion);
+    int extrairePointsLimbe(double seuil_relatif, int pas, double *l, double *c, int nb_max);
+    bool calculerCentroide(double seuil_relatif, double *l, double *c);
 
     // Entrées/sorties (depuis/vers)
     unsigned char* versUchar();
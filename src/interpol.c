@@ -51,7 +51,7 @@ static inline int max (int a, int b) {return (a > b) ? a:b ;}
 //--------------------------------------------------------------------------
 double it_pol_neville_s4 (double *f, double alpha)
 {
-	static double d [4][4];
+	double d [4][4];	// local (et non statique) : appelée en même temps par plusieurs threads
 
 	d[0][1] = ( alpha	  * f[1] - (alpha-1) * f[0] );
 	d[1][1] = ( (alpha-1) * f[2] - (alpha-2) * f[1] );
@@ -184,3 +184,43 @@ double it_pol_neville2D_s2 (
 		x_interm[1] = it_pol_neville_s2 ( &(f [indice_y1_inf +1][indice_x1_inf]), x_1 - indice_x1_inf);
 	return it_pol_neville_s2 (x_interm, y_1 - indice_y1_inf);// interpol finale en y
 }
+//--------------------------------------------------------------------------
+//      Interpolation 2D (Neville-Aitken) sur 4 fois 4 points, lue directement
+//      dans un tableau linéaire (par exemple le buffer d'une Image) : pas de
+//      copie en double** ; la zone n x m peut être une partie (ROI) du tableau
+//      parametres d'entree: n, m: dimensions de la zone
+//                           f: premier element de la zone
+//                           pas: ecart entre deux lignes du tableau (sa largeur)
+//                           y_1, x_1: point (x,y) ou on veut l'interpolation,
+//                                     par rapport au premier element de la zone
+//     donne en retour:		 valeur interpolee (la meme que it_pol_neville2D_s4
+//                           sur une copie de la zone)
+//--------------------------------------------------------------------------
+double it_pol_neville2D_s4_pas (
+	int n,				// taille de la zone en y
+	int m,				// taille de la zone en x
+	const double *f,	// premier element de la zone
+	int pas,			// nombre d'elements entre deux lignes du tableau source
+	double y_1,			// coordonnée y du point pour lequel on veut une val interpolée
+	double x_1)			// coordonnée x du point pour lequel on veut une val interpolée
+{
+	int i;
+	double	x_interm [4];	// tableau intermediaire local : appels simultanes possibles
+
+	// ---------------- determination de la zone a selectionner en X ------------------
+	int indice_x1_inf = (int)floor (x_1) - 1;	// centrer la zone d'interpol autour de x_1
+	indice_x1_inf = max (indice_x1_inf, 0);		// butee inf
+	indice_x1_inf = min (indice_x1_inf, m-4);	// butee sup
+	// ---------------- determination de la zone a selectionner en Y ------------------
+	int indice_y1_inf = (int)floor (y_1) - 1;	// centrer la zone d'interpol autour de y_1
+	indice_y1_inf = max (indice_y1_inf, 0);		// butee inf
+	indice_y1_inf = min (indice_y1_inf, n-4);	// butee sup
+	// ------ boucle sur les x : interpols en y mises dans un tableau temporaire ------
+	for (i=0; i<4; i++)
+	{
+		// it_pol_neville_s4 ne modifie pas f
+		x_interm[i] = it_pol_neville_s4 ((double*)(f + (indice_y1_inf +i)*pas + indice_x1_inf),
+										x_1 - indice_x1_inf);
+	}
+	return it_pol_neville_s4 (x_interm, y_1 - indice_y1_inf);// interpol finale en y
+}
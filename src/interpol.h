@@ -67,6 +67,16 @@ double it_pol_neville2D_s2 (
 	double x1,			// coordonnée x du point pour lequel on veut une val interpolée
 	double y1);			// coordonnée y du point pour lequel on veut une val interpolée
 
+// Même interpolation que it_pol_neville2D_s4, lue dans une zone n x m d'un tableau
+// linéaire dont les lignes sont espacées de "pas" éléments (sans copie en double**)
+double it_pol_neville2D_s4_pas (
+	int n,				// taille de la zone en y
+	int m,				// taille de la zone en x
+	const double *f,	// premier élément de la zone
+	int pas,			// nombre d'éléments entre deux lignes du tableau source
+	double y_1,			// coordonnée y du point par rapport au premier élément de la zone
+	double x_1);		// coordonnée x du point par rapport au premier élément de la zone
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,24 @@
+/*
+ * niveau_localisation.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Précision de la position envoyée par Capture à Guidage (signal resultats), dans un
+ *  fichier à part pour que guidage.h n'ait pas à inclure capture.h.
+ */
+
+#ifndef NIVEAU_LOCALISATION_H_
+#define NIVEAU_LOCALISATION_H_
+
+#include <QtCore/QMetaType>
+
+typedef enum {
+	NIVEAU_AUCUN,				// Aucune estimation avant la fin du délai de localisation
+	NIVEAU_CENTROIDE,			// Centroïde de l'image seulement (à quelques pixels près, sans signal/bruit)
+	NIVEAU_GROSSIER,			// Pic d'une image réduite de la pyramide (au pixel de ce niveau près)
+	NIVEAU_FIN					// Position sous-pixel (suivi, pyramide complète, corrélation complète, limbe...)
+} NiveauLocalisation;
+
+Q_DECLARE_METATYPE(NiveauLocalisation); // Pour utiliser ce type comme parametre signal/slot
+
+#endif /* NIVEAU_LOCALISATION_H_ */
@@ -0,0 +1,148 @@
+/*
+ * projections.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Un passage en O(lignes x colonnes) pour les projections de l'objet, puis deux
+ *  corrélations 1D de (2 x demi_fenetre + 1) décalages chacune, de la longueur de la
+ *  référence : quelques dizaines de milliers d'opérations au lieu des millions de la
+ *  fenêtre de suivi 2D.
+ */
+
+#include "projections.h"
+#include "correlateur.h"
+
+/**
+ * @param reference L'image de référence (laplacien de la forme du soleil)
+ * @param seuil_ref Seuil entre 0 et 1 (voir Image::referenceSeuillee)
+ */
+Projections::Projections(Image& reference, float seuil_ref) {
+	Image* ref = reference.referenceSeuillee(seuil_ref);
+	ref_lignes = ref->getLignes();
+	ref_colonnes = ref->getColonnes();
+	centre_l = ref_lignes-1-ref_lignes/2;
+	centre_c = ref_colonnes-1-ref_colonnes/2;
+	ref_l = new MonDouble[ref_lignes];
+	ref_c = new MonDouble[ref_colonnes];
+	for (int c=0; c < ref_colonnes; c++) {
+		ref_c[c] = 0;
+	}
+	for (int l=0; l < ref_lignes; l++) {
+		ref_l[l] = 0;
+		for (int c=0; c < ref_colonnes; c++) {
+			ref_l[l] += ref->getPix(l,c);
+			ref_c[c] += ref->getPix(l,c);
+		}
+	}
+	delete ref;
+	obj_l = obj_c = scores = NULL;
+	lignes = colonnes = taille_scores = 0;
+}
+
+Projections::~Projections() {
+	delete [] ref_l;
+	delete [] ref_c;
+	if(obj_l) delete [] obj_l;
+	if(obj_c) delete [] obj_c;
+	if(scores) delete [] scores;
+}
+
+/**
+ * Alloue les espaces de travail s'ils sont trop petits
+ */
+void Projections::preparer(int lignes, int colonnes, int demi_fenetre) {
+	if(lignes != this->lignes || colonnes != this->colonnes) {
+		if(obj_l) delete [] obj_l;
+		if(obj_c) delete [] obj_c;
+		obj_l = new MonDouble[lignes];
+		obj_c = new MonDouble[colonnes];
+		this->lignes = lignes;
+		this->colonnes = colonnes;
+	}
+	if(2*demi_fenetre+1 > taille_scores) {
+		if(scores) delete [] scores;
+		taille_scores = 2*demi_fenetre+1;
+		scores = new MonDouble[taille_scores];
+	}
+}
+
+/**
+ * Pic de la corrélation 1D d'une projection de l'objet avec celle de la référence, pour
+ * les décalages estime-demi_fenetre à estime+demi_fenetre (le décalage p met le centre
+ * de la référence sur l'élément p de l'objet, comme l'espace de corrélation centré)
+ * @param position Position sous-pixel du pic (parabole sur les trois scores autour du maximum)
+ * @param contraste Pic divisé par la moyenne des scores de la fenêtre
+ * @return false si le pic est au bord de la fenêtre ou si la fenêtre sort de l'objet
+ */
+bool Projections::chercherPic(const MonDouble* ref, int ref_taille, int centre, const MonDouble* obj, int obj_taille,
+		int estime, int demi_fenetre, double *position, double *contraste) {
+	int deb = estime - demi_fenetre;
+	if(deb < 0 || estime + demi_fenetre >= obj_taille) {
+		return false;
+	}
+	int i_max = 0;
+	double somme = 0;
+	for (int i=0; i < 2*demi_fenetre+1; i++) {
+		// Éléments de la référence qui tombent dans l'objet
+		int decal = deb + i - centre;
+		int k_deb = max(0, -decal), k_fin = min(ref_taille, obj_taille - decal);
+		MonDouble score = 0;
+		for (int k = k_deb; k < k_fin; k++) {
+			score += ref[k] * obj[k + decal];
+		}
+		scores[i] = score;
+		somme += score;
+		if(score > scores[i_max]) {
+			i_max = i;
+		}
+	}
+	if(i_max == 0 || i_max == 2*demi_fenetre || somme <= 0) {
+		return false;
+	}
+	double a = scores[i_max-1], b = scores[i_max], c = scores[i_max+1];
+	double courbure = a - 2*b + c;
+	*position = deb + i_max + ((courbure < 0) ? 0.5*(a - c)/courbure : 0);
+	*contraste = b / (somme / (2*demi_fenetre+1));
+	return true;
+}
+
+/**
+ * Position du soleil par les projections de l'objet, dans une fenêtre autour d'une position estimée
+ * @param obj L'image objet (dérivée de l'image capturée)
+ * @param l_estime Position estimée (la dernière position), dans l'espace centré
+ * @param c_estime
+ * @param demi_fenetre En px, on cherche de estime-demi_fenetre à estime+demi_fenetre
+ * @param l Position trouvée
+ * @param c
+ * @param contraste Le plus petit contraste (pic / moyenne de la fenêtre) des deux projections
+ * @return false si un des pics touche le bord de la fenêtre
+ */
+bool Projections::trouverPosition(Image& obj, double l_estime, double c_estime, int demi_fenetre,
+		double *l, double *c, double *contraste) {
+#if DEBUG
+	double temps_calcul = (double)(clock());
+#endif
+	preparer(obj.getLignes(), obj.getColonnes(), demi_fenetre);
+	for (int j=0; j < colonnes; j++) {
+		obj_c[j] = 0;
+	}
+	for (int i=0; i < lignes; i++) {
+		const MonDouble *ligne = obj.ptr() + i*colonnes;
+		MonDouble somme = 0;
+		for (int j=0; j < colonnes; j++) {
+			somme += ligne[j];
+			obj_c[j] += ligne[j];
+		}
+		obj_l[i] = somme;
+	}
+	double contraste_l, contraste_c;
+	if(!chercherPic(ref_l, ref_lignes, centre_l, obj_l, lignes, (int)(l_estime + 0.5), demi_fenetre, l, &contraste_l)
+			|| !chercherPic(ref_c, ref_colonnes, centre_c, obj_c, colonnes, (int)(c_estime + 0.5), demi_fenetre, c, &contraste_c)) {
+		return false;
+	}
+	*contraste = min(contraste_l, contraste_c);
+#if DEBUG
+	printf ("Temps projections = %4.4f s (contraste %.3f)\n", (double)(clock() - temps_calcul) /CLOCKS_PER_SEC, *contraste);
+#endif
+	return true;
+}
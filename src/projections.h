@@ -0,0 +1,40 @@
+/*
+ * projections.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Localisation "économique" par projections : la dérivée de l'image est sommée le long
+ *  des lignes et le long des colonnes (un passage sur l'image), puis chaque profil est
+ *  corrélé avec le profil de la référence seuillée dans une fenêtre autour de la dernière
+ *  position. La somme sur les colonnes de la corrélation 2D est la corrélation 1D des
+ *  projections : pour l'anneau du limbe, symétrique, les deux pics sont au même endroit.
+ *  Moins robuste que la corrélation 2D (un nuage déplace les deux profils) : sert entre
+ *  deux corrélations complètes (voir Capture::trouverPositionParProjections).
+ */
+
+#ifndef PROJECTIONS_H_
+#define PROJECTIONS_H_
+
+#include "image.h"
+
+class Projections {
+private:
+	// Projections de la référence seuillée (sommes des lignes, indicées par la ligne, et
+	// des colonnes) et position de son centre
+	MonDouble *ref_l, *ref_c;
+	int ref_lignes, ref_colonnes, centre_l, centre_c;
+	// Projections de l'objet et scores d'une fenêtre (espaces de travail)
+	MonDouble *obj_l, *obj_c, *scores;
+	int lignes, colonnes, taille_scores;
+
+	void preparer(int lignes, int colonnes, int demi_fenetre);
+	bool chercherPic(const MonDouble* ref, int ref_taille, int centre, const MonDouble* obj, int obj_taille,
+			int estime, int demi_fenetre, double *position, double *contraste);
+public:
+	Projections(Image& reference, float seuil_ref);
+	~Projections();
+	bool trouverPosition(Image& obj, double l_estime, double c_estime, int demi_fenetre,
+			double *l, double *c, double *contraste);
+};
+
+#endif /* PROJECTIONS_H_ */
@@ -0,0 +1,118 @@
+/*
+ * threads_calcul.cpp
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Les threads sont créés une fois pour toutes et attendent un calcul (cond_travail).
+ *  Le thread qui appelle executer() participe au calcul, puis attend que toutes les
+ *  tâches soient finies : à la sortie d'executer(), le résultat est complet.
+ */
+
+#include "threads_calcul.h"
+
+/**
+ * @param nb_threads Nombre de threads qui font le calcul, y compris le thread appelant
+ * (1 ou moins : tout est calculé par le thread appelant)
+ */
+ThreadsCalcul::ThreadsCalcul(int nb_threads) {
+	this->nb_threads = (nb_threads < 1) ? 1 : nb_threads;
+	tache = NULL;
+	contexte = NULL;
+	nb_taches = prochaine_tache = taches_finies = 0;
+	generation = 0;
+	arreter = false;
+	pthread_mutex_init(&verrou, NULL);
+	pthread_cond_init(&cond_travail, NULL);
+	pthread_cond_init(&cond_fini, NULL);
+
+	threads = new pthread_t[this->nb_threads];
+	arguments = new ArgumentThread[this->nb_threads];
+	for (int i=1; i < this->nb_threads; i++) { // Le thread 0 est le thread appelant
+		arguments[i].groupe = this;
+		arguments[i].num_thread = i;
+		if(pthread_create(&threads[i], NULL, boucleThread, &arguments[i]) != 0) {
+			this->nb_threads = i; // On fait avec les threads déjà créés
+			break;
+		}
+	}
+}
+
+ThreadsCalcul::~ThreadsCalcul() {
+	pthread_mutex_lock(&verrou);
+	arreter = true;
+	pthread_cond_broadcast(&cond_travail);
+	pthread_mutex_unlock(&verrou);
+	for (int i=1; i < nb_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	pthread_cond_destroy(&cond_travail);
+	pthread_cond_destroy(&cond_fini);
+	pthread_mutex_destroy(&verrou);
+	delete [] threads;
+	delete [] arguments;
+}
+
+/**
+ * Exécute les tâches 0 à nb_taches-1 réparties sur les threads ; revient quand
+ * toutes les tâches sont finies
+ * @param tache La fonction appelée pour chaque tâche
+ * @param contexte Le paramètre passé à chaque appel de la tâche
+ * @param nb_taches
+ */
+void ThreadsCalcul::executer(TacheCalcul tache, void* contexte, int nb_taches) {
+	if(nb_threads == 1 || nb_taches <= 1) {
+		for (int i=0; i < nb_taches; i++) {
+			tache(contexte, i, 0);
+		}
+		return;
+	}
+	pthread_mutex_lock(&verrou);
+	this->tache = tache;
+	this->contexte = contexte;
+	this->nb_taches = nb_taches;
+	prochaine_tache = taches_finies = 0;
+	generation++;
+	pthread_cond_broadcast(&cond_travail);
+	travailler(0);
+	while(taches_finies < nb_taches) {
+		pthread_cond_wait(&cond_fini, &verrou);
+	}
+	pthread_mutex_unlock(&verrou);
+}
+
+/**
+ * Fait les tâches restantes du calcul en cours (le verrou doit être pris)
+ */
+void ThreadsCalcul::travailler(int num_thread) {
+	while(prochaine_tache < nb_taches) {
+		int indice = prochaine_tache++;
+		pthread_mutex_unlock(&verrou);
+		tache(contexte, indice, num_thread);
+		pthread_mutex_lock(&verrou);
+		if(++taches_finies == nb_taches) {
+			pthread_cond_broadcast(&cond_fini);
+		}
+	}
+}
+
+/**
+ * Boucle des threads de calcul : attente d'un nouveau calcul, puis participation
+ */
+void* ThreadsCalcul::boucleThread(void* argument) {
+	ArgumentThread* arg = (ArgumentThread*)argument;
+	ThreadsCalcul* groupe = arg->groupe;
+	pthread_mutex_lock(&groupe->verrou);
+	int generation_vue = groupe->generation;
+	while(true) {
+		while(!groupe->arreter && groupe->generation == generation_vue) {
+			pthread_cond_wait(&groupe->cond_travail, &groupe->verrou);
+		}
+		if(groupe->arreter) {
+			break;
+		}
+		generation_vue = groupe->generation;
+		groupe->travailler(arg->num_thread);
+	}
+	pthread_mutex_unlock(&groupe->verrou);
+	return NULL;
+}
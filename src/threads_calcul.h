@@ -0,0 +1,53 @@
+/*
+ * threads_calcul.h
+ *
+ *  Created on: 17 oct. 2026
+ *
+ *  Groupe de threads de calcul (pthreads) gardés en attente d'une corrélation
+ *  à l'autre. Un calcul est découpé en tâches indépendantes (par exemple les tuiles
+ *  de l'espace de corrélation) qui écrivent chacune dans leur propre partie du
+ *  résultat : le résultat ne dépend donc pas du nombre de threads ni de l'ordre
+ *  dans lequel les tâches sont faites.
+ */
+
+#ifndef THREADS_CALCUL_H_
+#define THREADS_CALCUL_H_
+
+#include <pthread.h>
+
+/**
+ * Une tâche : "indice" est le numéro de la tâche (de 0 à nb_taches-1) et
+ * "num_thread" celui du thread qui l'exécute (de 0 à getNombreThreads()-1),
+ * pour choisir un espace de travail propre au thread
+ */
+typedef void (*TacheCalcul)(void* contexte, int indice, int num_thread);
+
+class ThreadsCalcul {
+private:
+	int nb_threads;		// Y compris le thread appelant executer()
+	pthread_t* threads;
+	pthread_mutex_t verrou;
+	pthread_cond_t cond_travail;	// Un nouveau calcul est disponible (ou il faut s'arrêter)
+	pthread_cond_t cond_fini;		// Toutes les tâches du calcul sont finies
+	TacheCalcul tache;
+	void* contexte;
+	int nb_taches, prochaine_tache, taches_finies;
+	int generation;		// Numéro du calcul en cours
+	bool arreter;
+
+	typedef struct {
+		ThreadsCalcul* groupe;
+		int num_thread;
+	} ArgumentThread;
+	ArgumentThread* arguments;
+
+	static void* boucleThread(void* argument);
+	void travailler(int num_thread);
+public:
+	ThreadsCalcul(int nb_threads);
+	~ThreadsCalcul();
+	void executer(TacheCalcul tache, void* contexte, int nb_taches);
+	int getNombreThreads() { return nb_threads; }
+};
+
+#endif /* THREADS_CALCUL_H_ */